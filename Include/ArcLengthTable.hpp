@@ -0,0 +1,40 @@
+﻿/**
+ * \file ArcLengthTable.hpp
+ * \brief Arc length reparameterization of Bezier curves
+ * \author Elekhyr
+ * \version 1.0
+ * \date 19/10/2026
+ * \copyright Copyright (c) 2017 Thomas Margier
+ *  This file is licensed under the MIT License, see https://opensource.org/licenses/MIT
+ */
+
+#pragma once
+#include <vector>
+#include "Vec4.hpp" //todo : fix issue when including vec3 before vec4
+#include "Vec3.hpp"
+
+namespace Math
+{
+	/**
+	 * Cumulative arc length of a curve at nbSegments + 1 uniform parameters, and its inverse.
+	 * \details Each segment is integrated with 5 points Gauss-Legendre on the speed
+	 *	given by BezierCurve::EvaluateWithDerivatives. The cumulative lengths are
+	 *	monotone, so the inverse is a binary search followed by a linear interpolation.
+	 *	A second table, sampled at uniform lengths, answers the same query in constant time.
+	 */
+	class ArcLengthTable
+	{
+	public:
+		ArcLengthTable(const std::vector<Vec4d>& controlPoints, unsigned nbSegments);
+
+		double Length() const; /// Length of the whole curve
+		double LengthAt(double u) const; /// Length from the start of the curve to u
+
+		double ParameterAtLength(double length) const; /// O(log n)
+		double ParameterAtLengthFast(double length) const; /// O(1), interpolated from the uniform length table
+
+	private:
+		std::vector<double> mLengths;
+		std::vector<double> mParameters;
+	};
+}
@@ -0,0 +1,53 @@
+﻿/**
+ * \file BernsteinBasis.hpp
+ * \brief Precomputed Bernstein basis tables for fixed-degree curve sampling
+ * \author Elekhyr
+ * \version 1.0
+ * \date 19/10/2026
+ * \copyright Copyright (c) 2017 Thomas Margier
+ *  This file is licensed under the MIT License, see https://opensource.org/licenses/MIT
+ */
+
+#pragma once
+#include <memory>
+#include <vector>
+#include "Vec4.hpp"
+#include "Vec3.hpp"
+
+namespace Math
+{
+	/**
+	 * Bernstein weights of a given degree sampled at nbPoints + 2 uniform parameters
+	 * (end points included), the same parameters ComputeWithDeCasteljau uses.
+	 * \details Weights are stored per control point so that sampling a curve becomes
+	 *	a dense (samples x controlPoints) * (controlPoints x 4) product whose inner
+	 *	loop runs over contiguous samples.
+	 */
+	class BernsteinBasis
+	{
+	public:
+		BernsteinBasis(unsigned degree, unsigned nbPoints);
+
+		/**
+		 * Shared table, built on first use.
+		 * \details Each thread looks first in the few tables it got last, without locking. The shared cache keeps
+		 *	the 64 tables built last, a dropped table living on while a caller holds it.
+		 */
+		static std::shared_ptr<const BernsteinBasis> Get(unsigned degree, unsigned nbPoints);
+		static void Evaluate(unsigned degree, double u, double* values); /// Fill values[0..degree] with B(i, degree)(u)
+		static void Evaluate(unsigned degree, double u, double* values, double* derivatives); /// Also fill the derivatives in u
+
+		unsigned Degree() const;
+		unsigned NbSamples() const;
+		double Parameter(unsigned sample) const;
+		const double* Column(unsigned controlPoint) const; /// Weights of one control point for every sample
+
+		std::vector<Vec3d> Apply(const std::vector<Vec4d>& controlPoints) const;
+		void Apply(const Vec4d* controlPoints, Vec3d* curve) const; /// curve must hold NbSamples() points
+
+	private:
+		unsigned mDegree;
+		unsigned mNbSamples;
+		std::vector<double> mWeights;
+	};
+}
@@ -15,8 +15,76 @@
 
 namespace Math
 {
+	/**
+	 * Point of a curve with its derivatives with respect to the curve parameter
+	 */
+	struct BezierSample
+	{
+		Vec3d position;
+		Vec3d derivative; /// Tangent direction, not normalized
+		Vec3d secondDerivative;
+		double curvature;
+	};
+
+	/**
+	 * Point of a curve closest to a query point
+	 */
+	struct BezierProjection
+	{
+		double parameter;
+		Vec3d position;
+		double distance;
+	};
+
 	struct BezierCurve
 	{
 		static std::vector<Vec3d> ComputeWithDeCasteljau(const std::vector<Vec4d>& controlPoints, unsigned nbPoints);
+		static std::vector<Vec3d> ComputeWithFixedDegree(const std::vector<Vec4d>& controlPoints, unsigned nbPoints); /// Same parameters, lines, quadratics and cubics through FixedBezierCurve
+		static std::vector<Vec3d> ComputeWithBasis(const std::vector<Vec4d>& controlPoints, unsigned nbPoints); /// Same samples, through a cached BernsteinBasis
+
+		/**
+		 * Polyline of the curve, subdivided with de Casteljau until every piece is flat
+		 * \details A piece is flat when its control points are within tolerance of the chord
+		 *	joining its end points, which bounds the distance between the curve and the polyline.
+		 */
+		static std::vector<Vec3d> ComputeAdaptive(const std::vector<Vec4d>& controlPoints, double tolerance);
+
+		/**
+		 * Sample many curves at once, over every hardware thread
+		 * \details Curve i owns controlPoints[offsets[i]] to controlPoints[offsets[i + 1] - 1],
+		 *	its nbPoints + 2 samples are written from curve[i * (nbPoints + 2)].
+		 *	Runs of curves sharing a degree are evaluated side by side, one per vector lane.
+		 */
+		static void ComputeBatch(const std::vector<Vec4d>& controlPoints, const std::vector<size_t>& offsets,
+			unsigned nbPoints, std::vector<Vec3d>& curve);
+
+		/**
+		 * Position, first and second derivatives from a single de Casteljau pass
+		 * \details The derivatives come from the last two levels of the triangle in homogeneous
+		 *	coordinates, then go through the quotient rule so rational curves are exact.
+		 */
+		static BezierSample EvaluateWithDerivatives(const std::vector<Vec4d>& controlPoints, double u);
+		static std::vector<BezierSample> EvaluateWithDerivatives(const std::vector<Vec4d>& controlPoints, const std::vector<double>& parameters);
+		static void EvaluateWithDerivatives(const std::vector<Vec4d>& controlPoints, const double* parameters, size_t count, BezierSample* samples); /// samples must hold count samples
+		static std::vector<BezierSample> ComputeWithDerivatives(const std::vector<Vec4d>& controlPoints, unsigned nbPoints);
+
+		static void Split(const std::vector<Vec4d>& controlPoints, double u, std::vector<Vec4d>& left, std::vector<Vec4d>& right);
+
+		static void HullBounds(const std::vector<Vec4d>& controlPoints, Vec3d& min, Vec3d& max); /// Box of the control points, holds the curve
+
+		/**
+		 * Tightest axis aligned box of the curve
+		 * \details Polynomial curves use their end points and the roots of the derivative on each axis.
+		 *	Rational curves use the hull bounds of 16 sub-curves, conservative and within O(1/256) of the curve.
+		 */
+		static void Bounds(const std::vector<Vec4d>& controlPoints, Vec3d& min, Vec3d& max);
+
+		/**
+		 * Closest point of the curve, by recursive subdivision
+		 * \details Sub-curves whose hull box is farther than the best candidate are dropped,
+		 *	flat ones are projected on their chord and refined with Newton steps.
+		 */
+		static BezierProjection ClosestPoint(const std::vector<Vec4d>& controlPoints, const Vec3d& point, double tolerance);
+		static bool HitTest(const std::vector<Vec4d>& controlPoints, const Vec3d& point, double radius); /// Stops at the first point within radius
 	};
 }
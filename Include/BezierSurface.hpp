@@ -0,0 +1,30 @@
+﻿/**
+ * \file BezierSurface.hpp
+ * \brief Tensor product rational Bezier patches
+ * \author Elekhyr
+ * \version 1.0
+ * \date 19/10/2026
+ * \copyright Copyright (c) 2017 Thomas Margier
+ *  This file is licensed under the MIT License, see https://opensource.org/licenses/MIT
+ */
+
+#pragma once
+#include <vector>
+#include "Vec4.hpp" //todo : fix issue when including vec3 before vec4
+#include "Vec3.hpp"
+
+namespace Math
+{
+	struct BezierSurface
+	{
+		/**
+		 * Grid of positions and unit normals over a patch, patch borders included
+		 * \details controlPoints is a nbRows x nbColumns grid stored row by row, with the weight
+		 *	in w as for BezierCurve. u runs along the rows and v along the columns; sample (i, j)
+		 *	is written at i * resolutionV + j. Bands of rows are tessellated on separate threads.
+		 *	Where the patch is degenerate (collapsed edge), the normal is taken slightly inside.
+		 */
+		static void Tessellate(const std::vector<Vec4d>& controlPoints, unsigned nbRows, unsigned nbColumns,
+			unsigned resolutionU, unsigned resolutionV, std::vector<Vec3d>& positions, std::vector<Vec3d>& normals);
+	};
+}
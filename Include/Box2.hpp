@@ -0,0 +1,287 @@
+﻿/**
+ * \file Box2.hpp
+ * \brief 2D axis aligned bounding box
+ * \author Elekhyr
+ * \version 1.0
+ * \date 19/10/2026
+ * \copyright Copyright (c) 2017 Thomas Margier
+ *  This file is licensed under the MIT License, see https://opensource.org/licenses/MIT
+ */
+#pragma once
+#include <algorithm>
+#include <limits>
+#include "Vec4.hpp" //todo : fix issue when including vec3 before vec4
+#include "Vec3.hpp"
+#include "Vec2.hpp"
+
+namespace Math
+{
+	/**
+	 * Axis aligned box between min and max, bounds included.
+	 * \details The default box is empty (min above max), so merging points into it gives their bounds.
+	 */
+	template <typename T>
+	struct Box2
+	{
+		static_assert(std::is_arithmetic<T>::value, "T must be numeric");
+
+		// Constructors
+		Box2(); /// Empty box
+		Box2(const Vec2<T>& min, const Vec2<T>& max);
+
+		// Functions
+		bool IsEmpty() const;
+		Vec2<T> Center() const;
+		Vec2<T> Size() const;
+		T Area() const;
+
+		void Merge(const Vec2<T>& point);
+		void Merge(const Box2& box);
+
+		bool Overlaps(const Box2& box) const;
+		bool Contains(const Vec2<T>& point) const;
+		bool Contains(const Box2& box) const;
+
+		/**
+		 * Slab test of the ray origin + t * direction, given 1 / direction.
+		 * \details Clips [tMin, tMax] to the part of the ray inside the box, false when nothing is left.
+		 */
+		bool IntersectRay(const Vec2<T>& origin, const Vec2<T>& inverseDirection, T& tMin, T& tMax) const;
+
+		// Attributes
+		Vec2<T> min;
+		Vec2<T> max;
+	};
+
+	/**
+	 * N boxes stored as one array per bound component, to test a ray against all of them at once.
+	 * \details Same layout and lanes as Box3Packet: the slab test has no branch, so the compiler turns
+	 *	it into SIMD code for N = 4 or 8. Unused lanes hold NaN bounds and never report a hit.
+	 */
+	template <typename T, unsigned N>
+	struct Box2Packet
+	{
+		static_assert(std::is_floating_point<T>::value, "T must be a floating point type");
+		static_assert(N > 0 && N <= 32 && (N & (N - 1)) == 0, "N must be a power of two up to 32");
+
+		Box2Packet(); /// Every lane unused
+
+		void Set(unsigned i, const Box2<T>& box);
+		void Clear(unsigned i); /// Mark lane i unused
+		Box2<T> Get(unsigned i) const;
+
+		/**
+		 * Bit i of the result is set when the ray hits box i within [tMin, tMax].
+		 * \details tEntry, when given, receives the entry distance of each lane (meaningless for lanes without a hit).
+		 */
+		unsigned IntersectRay(const Vec2<T>& origin, const Vec2<T>& inverseDirection, T tMin, T tMax, T* tEntry = nullptr) const;
+		unsigned Overlaps(const Box2<T>& box) const; /// Bit i set when box overlaps lane i
+
+		alignas(N * sizeof(T) > 32 ? 32 : N * sizeof(T)) T minX[N];
+		alignas(N * sizeof(T) > 32 ? 32 : N * sizeof(T)) T minY[N];
+		alignas(N * sizeof(T) > 32 ? 32 : N * sizeof(T)) T maxX[N];
+		alignas(N * sizeof(T) > 32 ? 32 : N * sizeof(T)) T maxY[N];
+	};
+
+	template <typename T>
+	Box2<T>::Box2()
+		: min(std::numeric_limits<T>::max(), std::numeric_limits<T>::max()),
+		max(std::numeric_limits<T>::lowest(), std::numeric_limits<T>::lowest()) {
+	}
+
+	template <typename T>
+	Box2<T>::Box2(const Vec2<T>& min, const Vec2<T>& max)
+		: min(min), max(max) {
+	}
+
+	template <typename T>
+	bool Box2<T>::IsEmpty () const {
+		return min.x > max.x || min.y > max.y;
+	}
+
+	template <typename T>
+	Vec2<T> Box2<T>::Center () const {
+		return Vec2<T>((min.x + max.x) / 2, (min.y + max.y) / 2);
+	}
+
+	template <typename T>
+	Vec2<T> Box2<T>::Size () const {
+		return IsEmpty() ? Vec2<T>(0, 0) : Vec2<T>(max.x - min.x, max.y - min.y);
+	}
+
+	template <typename T>
+	T Box2<T>::Area () const {
+		const auto size = Size();
+		return size.x * size.y;
+	}
+
+	template <typename T>
+	void Box2<T>::Merge (const Vec2<T>& point) {
+		min.x = std::min(min.x, point.x);
+		min.y = std::min(min.y, point.y);
+		max.x = std::max(max.x, point.x);
+		max.y = std::max(max.y, point.y);
+	}
+
+	template <typename T>
+	void Box2<T>::Merge (const Box2& box) {
+		min.x = std::min(min.x, box.min.x);
+		min.y = std::min(min.y, box.min.y);
+		max.x = std::max(max.x, box.max.x);
+		max.y = std::max(max.y, box.max.y);
+	}
+
+	template <typename T>
+	bool Box2<T>::Overlaps (const Box2& box) const {
+		return min.x <= box.max.x && box.min.x <= max.x
+			&& min.y <= box.max.y && box.min.y <= max.y;
+	}
+
+	template <typename T>
+	bool Box2<T>::Contains (const Vec2<T>& point) const {
+		return point.x >= min.x && point.x <= max.x
+			&& point.y >= min.y && point.y <= max.y;
+	}
+
+	template <typename T>
+	bool Box2<T>::Contains (const Box2& box) const {
+		return box.IsEmpty() || (box.min.x >= min.x && box.max.x <= max.x
+			&& box.min.y >= min.y && box.max.y <= max.y);
+	}
+
+	template <typename T>
+	bool Box2<T>::IntersectRay (const Vec2<T>& origin, const Vec2<T>& inverseDirection, T& tMin, T& tMax) const {
+		if (IsEmpty())
+		{
+			return false;
+		}
+
+		const T tx1 = (min.x - origin.x) * inverseDirection.x;
+		const T tx2 = (max.x - origin.x) * inverseDirection.x;
+		const T ty1 = (min.y - origin.y) * inverseDirection.y;
+		const T ty2 = (max.y - origin.y) * inverseDirection.y;
+
+		tMin = std::max(tMin, std::max(std::min(tx1, tx2), std::min(ty1, ty2)));
+		tMax = std::min(tMax, std::min(std::max(tx1, tx2), std::max(ty1, ty2)));
+		return tMin <= tMax;
+	}
+
+	template <typename T, unsigned N>
+	Box2Packet<T, N>::Box2Packet() {
+		for (unsigned i = 0; i < N; ++i)
+		{
+			Clear(i);
+		}
+	}
+
+	template <typename T, unsigned N>
+	void Box2Packet<T, N>::Set (const unsigned i, const Box2<T>& box) {
+		if (box.IsEmpty())
+		{
+			Clear(i);
+			return;
+		}
+		minX[i] = box.min.x;
+		minY[i] = box.min.y;
+		maxX[i] = box.max.x;
+		maxY[i] = box.max.y;
+	}
+
+	template <typename T, unsigned N>
+	void Box2Packet<T, N>::Clear (const unsigned i) {
+		const T nan = std::numeric_limits<T>::quiet_NaN();
+		minX[i] = minY[i] = nan;
+		maxX[i] = maxY[i] = nan;
+	}
+
+	template <typename T, unsigned N>
+	Box2<T> Box2Packet<T, N>::Get (const unsigned i) const {
+		if (minX[i] != minX[i])
+		{
+			return Box2<T>();
+		}
+		return Box2<T>(Vec2<T>(minX[i], minY[i]), Vec2<T>(maxX[i], maxY[i]));
+	}
+
+	template <typename T, unsigned N>
+	unsigned Box2Packet<T, N>::IntersectRay (const Vec2<T>& origin, const Vec2<T>& inverseDirection, const T tMin, const T tMax, T* tEntry) const {
+		alignas(N * sizeof(T) > 32 ? 32 : N * sizeof(T)) T entries[N];
+		unsigned char hits[N];
+
+		// Selects written as a < b ? a : b map to minps / maxps, unused lanes fail minX == minX
+		for (unsigned i = 0; i < N; ++i)
+		{
+			const T tx1 = (minX[i] - origin.x) * inverseDirection.x;
+			const T tx2 = (maxX[i] - origin.x) * inverseDirection.x;
+			const T ty1 = (minY[i] - origin.y) * inverseDirection.y;
+			const T ty2 = (maxY[i] - origin.y) * inverseDirection.y;
+
+			const T nearX = tx1 < tx2 ? tx1 : tx2, farX = tx1 < tx2 ? tx2 : tx1;
+			const T nearY = ty1 < ty2 ? ty1 : ty2, farY = ty1 < ty2 ? ty2 : ty1;
+
+			T entry = nearX > tMin ? nearX : tMin;
+			entry = nearY > entry ? nearY : entry;
+			T exit = farX < tMax ? farX : tMax;
+			exit = farY < exit ? farY : exit;
+
+			entries[i] = entry;
+			hits[i] = entry <= exit && minX[i] == minX[i];
+		}
+
+		unsigned mask = 0;
+		for (unsigned i = 0; i < N; ++i)
+		{
+			mask |= unsigned(hits[i]) << i;
+			if (tEntry)
+			{
+				tEntry[i] = entries[i];
+			}
+		}
+		return mask;
+	}
+
+	template <typename T, unsigned N>
+	unsigned Box2Packet<T, N>::Overlaps (const Box2<T>& box) const {
+		unsigned char hits[N];
+		for (unsigned i = 0; i < N; ++i)
+		{
+			hits[i] = (minX[i] <= box.max.x) & (box.min.x <= maxX[i])
+				& (minY[i] <= box.max.y) & (box.min.y <= maxY[i]);
+		}
+
+		unsigned mask = 0;
+		for (unsigned i = 0; i < N; ++i)
+		{
+			mask |= unsigned(hits[i]) << i;
+		}
+		return mask;
+	}
+
+	//Stream operator
+	template <typename T>
+	std::ostream& operator<<(std::ostream& out, const Box2<T>& box)
+	{
+		return out << "[" << box.min << ", " << box.max << "]";
+	}
+
+	// Relational operators
+	template <typename T>
+	bool operator==(const Box2<T>& lhs, const Box2<T>& rhs)
+	{
+		return lhs.min == rhs.min && lhs.max == rhs.max;
+	}
+
+	template <typename T>
+	bool operator!=(const Box2<T>& lhs, const Box2<T>& rhs)
+	{
+		return !(lhs == rhs);
+	}
+
+	typedef Box2<int> Box2i;
+	typedef Box2<float> Box2f;
+	typedef Box2<double> Box2d;
+
+	typedef Box2Packet<float, 4> Box2Packet4f;
+	typedef Box2Packet<float, 8> Box2Packet8f;
+	typedef Box2Packet<double, 4> Box2Packet4d;
+}
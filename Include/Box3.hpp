@@ -0,0 +1,313 @@
+﻿/**
+ * \file Box3.hpp
+ * \brief 3D axis aligned bounding box
+ * \author Elekhyr
+ * \version 1.0
+ * \date 19/10/2026
+ * \copyright Copyright (c) 2017 Thomas Margier
+ *  This file is licensed under the MIT License, see https://opensource.org/licenses/MIT
+ */
+#pragma once
+#include <algorithm>
+#include <limits>
+#include "Vec4.hpp" //todo : fix issue when including vec3 before vec4
+#include "Vec3.hpp"
+
+namespace Math
+{
+	/**
+	 * Axis aligned box between min and max, bounds included.
+	 * \details The default box is empty (min above max), so merging points into it gives their bounds.
+	 */
+	template <typename T>
+	struct Box3
+	{
+		static_assert(std::is_arithmetic<T>::value, "T must be numeric");
+
+		// Constructors
+		Box3(); /// Empty box
+		Box3(const Vec3<T>& min, const Vec3<T>& max);
+
+		// Functions
+		bool IsEmpty() const;
+		Vec3<T> Center() const;
+		Vec3<T> Size() const;
+		T Volume() const;
+		T SurfaceArea() const;
+
+		void Merge(const Vec3<T>& point);
+		void Merge(const Box3& box);
+
+		bool Overlaps(const Box3& box) const;
+		bool Contains(const Vec3<T>& point) const;
+		bool Contains(const Box3& box) const;
+
+		/**
+		 * Slab test of the ray origin + t * direction, given 1 / direction.
+		 * \details Clips [tMin, tMax] to the part of the ray inside the box, false when nothing is left.
+		 */
+		bool IntersectRay(const Vec3<T>& origin, const Vec3<T>& inverseDirection, T& tMin, T& tMax) const;
+
+		// Attributes
+		Vec3<T> min;
+		Vec3<T> max;
+	};
+
+	/**
+	 * N boxes stored as one array per bound component, to test a ray against all of them at once.
+	 * \details IntersectRay runs the slab test on every lane with no branch, so the compiler turns it
+	 *	into SIMD code for N = 4 or 8 (SSE or AVX with float, AVX with double). Unused lanes hold
+	 *	NaN bounds and never report a hit.
+	 */
+	template <typename T, unsigned N>
+	struct Box3Packet
+	{
+		static_assert(std::is_floating_point<T>::value, "T must be a floating point type");
+		static_assert(N > 0 && N <= 32 && (N & (N - 1)) == 0, "N must be a power of two up to 32");
+
+		Box3Packet(); /// Every lane unused
+
+		void Set(unsigned i, const Box3<T>& box);
+		void Clear(unsigned i); /// Mark lane i unused
+		Box3<T> Get(unsigned i) const;
+
+		/**
+		 * Bit i of the result is set when the ray hits box i within [tMin, tMax].
+		 * \details tEntry, when given, receives the entry distance of each lane (meaningless for lanes without a hit).
+		 */
+		unsigned IntersectRay(const Vec3<T>& origin, const Vec3<T>& inverseDirection, T tMin, T tMax, T* tEntry = nullptr) const;
+		unsigned Overlaps(const Box3<T>& box) const; /// Bit i set when box overlaps lane i
+
+		alignas(N * sizeof(T) > 32 ? 32 : N * sizeof(T)) T minX[N];
+		alignas(N * sizeof(T) > 32 ? 32 : N * sizeof(T)) T minY[N];
+		alignas(N * sizeof(T) > 32 ? 32 : N * sizeof(T)) T minZ[N];
+		alignas(N * sizeof(T) > 32 ? 32 : N * sizeof(T)) T maxX[N];
+		alignas(N * sizeof(T) > 32 ? 32 : N * sizeof(T)) T maxY[N];
+		alignas(N * sizeof(T) > 32 ? 32 : N * sizeof(T)) T maxZ[N];
+	};
+
+	template <typename T>
+	Box3<T>::Box3()
+		: min(std::numeric_limits<T>::max(), std::numeric_limits<T>::max(), std::numeric_limits<T>::max()),
+		max(std::numeric_limits<T>::lowest(), std::numeric_limits<T>::lowest(), std::numeric_limits<T>::lowest()) {
+	}
+
+	template <typename T>
+	Box3<T>::Box3(const Vec3<T>& min, const Vec3<T>& max)
+		: min(min), max(max) {
+	}
+
+	template <typename T>
+	bool Box3<T>::IsEmpty () const {
+		return min.x > max.x || min.y > max.y || min.z > max.z;
+	}
+
+	template <typename T>
+	Vec3<T> Box3<T>::Center () const {
+		return Vec3<T>((min.x + max.x) / 2, (min.y + max.y) / 2, (min.z + max.z) / 2);
+	}
+
+	template <typename T>
+	Vec3<T> Box3<T>::Size () const {
+		return IsEmpty() ? Vec3<T>(0, 0, 0) : Vec3<T>(max.x - min.x, max.y - min.y, max.z - min.z);
+	}
+
+	template <typename T>
+	T Box3<T>::Volume () const {
+		const auto size = Size();
+		return size.x * size.y * size.z;
+	}
+
+	template <typename T>
+	T Box3<T>::SurfaceArea () const {
+		const auto size = Size();
+		return 2 * (size.x * size.y + size.y * size.z + size.z * size.x);
+	}
+
+	template <typename T>
+	void Box3<T>::Merge (const Vec3<T>& point) {
+		min.x = std::min(min.x, point.x);
+		min.y = std::min(min.y, point.y);
+		min.z = std::min(min.z, point.z);
+		max.x = std::max(max.x, point.x);
+		max.y = std::max(max.y, point.y);
+		max.z = std::max(max.z, point.z);
+	}
+
+	template <typename T>
+	void Box3<T>::Merge (const Box3& box) {
+		min.x = std::min(min.x, box.min.x);
+		min.y = std::min(min.y, box.min.y);
+		min.z = std::min(min.z, box.min.z);
+		max.x = std::max(max.x, box.max.x);
+		max.y = std::max(max.y, box.max.y);
+		max.z = std::max(max.z, box.max.z);
+	}
+
+	template <typename T>
+	bool Box3<T>::Overlaps (const Box3& box) const {
+		return min.x <= box.max.x && box.min.x <= max.x
+			&& min.y <= box.max.y && box.min.y <= max.y
+			&& min.z <= box.max.z && box.min.z <= max.z;
+	}
+
+	template <typename T>
+	bool Box3<T>::Contains (const Vec3<T>& point) const {
+		return point.x >= min.x && point.x <= max.x
+			&& point.y >= min.y && point.y <= max.y
+			&& point.z >= min.z && point.z <= max.z;
+	}
+
+	template <typename T>
+	bool Box3<T>::Contains (const Box3& box) const {
+		return box.IsEmpty() || (box.min.x >= min.x && box.max.x <= max.x
+			&& box.min.y >= min.y && box.max.y <= max.y
+			&& box.min.z >= min.z && box.max.z <= max.z);
+	}
+
+	template <typename T>
+	bool Box3<T>::IntersectRay (const Vec3<T>& origin, const Vec3<T>& inverseDirection, T& tMin, T& tMax) const {
+		if (IsEmpty())
+		{
+			return false;
+		}
+
+		const T tx1 = (min.x - origin.x) * inverseDirection.x;
+		const T tx2 = (max.x - origin.x) * inverseDirection.x;
+		const T ty1 = (min.y - origin.y) * inverseDirection.y;
+		const T ty2 = (max.y - origin.y) * inverseDirection.y;
+		const T tz1 = (min.z - origin.z) * inverseDirection.z;
+		const T tz2 = (max.z - origin.z) * inverseDirection.z;
+
+		tMin = std::max(tMin, std::max(std::max(std::min(tx1, tx2), std::min(ty1, ty2)), std::min(tz1, tz2)));
+		tMax = std::min(tMax, std::min(std::min(std::max(tx1, tx2), std::max(ty1, ty2)), std::max(tz1, tz2)));
+		return tMin <= tMax;
+	}
+
+	template <typename T, unsigned N>
+	Box3Packet<T, N>::Box3Packet() {
+		for (unsigned i = 0; i < N; ++i)
+		{
+			Clear(i);
+		}
+	}
+
+	template <typename T, unsigned N>
+	void Box3Packet<T, N>::Set (const unsigned i, const Box3<T>& box) {
+		if (box.IsEmpty())
+		{
+			Clear(i);
+			return;
+		}
+		minX[i] = box.min.x;
+		minY[i] = box.min.y;
+		minZ[i] = box.min.z;
+		maxX[i] = box.max.x;
+		maxY[i] = box.max.y;
+		maxZ[i] = box.max.z;
+	}
+
+	template <typename T, unsigned N>
+	void Box3Packet<T, N>::Clear (const unsigned i) {
+		const T nan = std::numeric_limits<T>::quiet_NaN();
+		minX[i] = minY[i] = minZ[i] = nan;
+		maxX[i] = maxY[i] = maxZ[i] = nan;
+	}
+
+	template <typename T, unsigned N>
+	Box3<T> Box3Packet<T, N>::Get (const unsigned i) const {
+		if (minX[i] != minX[i])
+		{
+			return Box3<T>();
+		}
+		return Box3<T>(Vec3<T>(minX[i], minY[i], minZ[i]), Vec3<T>(maxX[i], maxY[i], maxZ[i]));
+	}
+
+	template <typename T, unsigned N>
+	unsigned Box3Packet<T, N>::IntersectRay (const Vec3<T>& origin, const Vec3<T>& inverseDirection, const T tMin, const T tMax, T* tEntry) const {
+		alignas(N * sizeof(T) > 32 ? 32 : N * sizeof(T)) T entries[N];
+		unsigned char hits[N];
+
+		// Selects written as a < b ? a : b map to minps / maxps, unused lanes fail minX == minX
+		for (unsigned i = 0; i < N; ++i)
+		{
+			const T tx1 = (minX[i] - origin.x) * inverseDirection.x;
+			const T tx2 = (maxX[i] - origin.x) * inverseDirection.x;
+			const T ty1 = (minY[i] - origin.y) * inverseDirection.y;
+			const T ty2 = (maxY[i] - origin.y) * inverseDirection.y;
+			const T tz1 = (minZ[i] - origin.z) * inverseDirection.z;
+			const T tz2 = (maxZ[i] - origin.z) * inverseDirection.z;
+
+			const T nearX = tx1 < tx2 ? tx1 : tx2, farX = tx1 < tx2 ? tx2 : tx1;
+			const T nearY = ty1 < ty2 ? ty1 : ty2, farY = ty1 < ty2 ? ty2 : ty1;
+			const T nearZ = tz1 < tz2 ? tz1 : tz2, farZ = tz1 < tz2 ? tz2 : tz1;
+
+			T entry = nearX > tMin ? nearX : tMin;
+			entry = nearY > entry ? nearY : entry;
+			entry = nearZ > entry ? nearZ : entry;
+			T exit = farX < tMax ? farX : tMax;
+			exit = farY < exit ? farY : exit;
+			exit = farZ < exit ? farZ : exit;
+
+			entries[i] = entry;
+			hits[i] = entry <= exit && minX[i] == minX[i];
+		}
+
+		unsigned mask = 0;
+		for (unsigned i = 0; i < N; ++i)
+		{
+			mask |= unsigned(hits[i]) << i;
+			if (tEntry)
+			{
+				tEntry[i] = entries[i];
+			}
+		}
+		return mask;
+	}
+
+	template <typename T, unsigned N>
+	unsigned Box3Packet<T, N>::Overlaps (const Box3<T>& box) const {
+		unsigned char hits[N];
+		for (unsigned i = 0; i < N; ++i)
+		{
+			hits[i] = (minX[i] <= box.max.x) & (box.min.x <= maxX[i])
+				& (minY[i] <= box.max.y) & (box.min.y <= maxY[i])
+				& (minZ[i] <= box.max.z) & (box.min.z <= maxZ[i]);
+		}
+
+		unsigned mask = 0;
+		for (unsigned i = 0; i < N; ++i)
+		{
+			mask |= unsigned(hits[i]) << i;
+		}
+		return mask;
+	}
+
+	//Stream operator
+	template <typename T>
+	std::ostream& operator<<(std::ostream& out, const Box3<T>& box)
+	{
+		return out << "[" << box.min << ", " << box.max << "]";
+	}
+
+	// Relational operators
+	template <typename T>
+	bool operator==(const Box3<T>& lhs, const Box3<T>& rhs)
+	{
+		return lhs.min == rhs.min && lhs.max == rhs.max;
+	}
+
+	template <typename T>
+	bool operator!=(const Box3<T>& lhs, const Box3<T>& rhs)
+	{
+		return !(lhs == rhs);
+	}
+
+	typedef Box3<int> Box3i;
+	typedef Box3<float> Box3f;
+	typedef Box3<double> Box3d;
+
+	typedef Box3Packet<float, 4> Box3Packet4f;
+	typedef Box3Packet<float, 8> Box3Packet8f;
+	typedef Box3Packet<double, 4> Box3Packet4d;
+}
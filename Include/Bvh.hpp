@@ -0,0 +1,755 @@
+﻿/**
+ * \file Bvh.hpp
+ * \brief Bounding volume hierarchy with 4 wide nodes
+ * \author Elekhyr
+ * \version 1.0
+ * \date 19/10/2026
+ * \copyright Copyright (c) 2017 Thomas Margier
+ *  This file is licensed under the MIT License, see https://opensource.org/licenses/MIT
+ */
+#pragma once
+#include <algorithm>
+#include <cstdint>
+#include <stdexcept>
+#include <limits>
+#include <queue>
+#include <vector>
+#include "Vec4.hpp" //todo : fix issue when including vec3 before vec4
+#include "Vec3.hpp"
+#include "Box3.hpp"
+#include "MemoryResource.hpp"
+#include "Parallel.hpp"
+
+namespace Math
+{
+	/**
+	 * Bounding volume hierarchy over the bounds of a set of objects, for ray, overlap and nearest queries.
+	 * \details The build bins object centroids along the longest axis of their bounds and splits
+	 *	where the surface area heuristic is lowest. Nodes of many objects are binned and partitioned over the hardware
+	 *	threads, then the subtrees below them are built in parallel, one thread each. The binary
+	 *	tree is then collapsed into nodes of 4 children whose boxes are tested together through
+	 *	Box3Packet, stored depth first in one array so a parent always comes before its children.
+	 *	A leaf lane holds a single object, so queries test the box of every object they report.
+	 *
+	 *	Objects are referred to by their index in the bounds given to the constructor.
+	 */
+	template <typename T>
+	class Bvh
+	{
+	public:
+		static const std::uint32_t kNone = 0xFFFFFFFF;
+
+		/**
+		 * 4 children: child[i] is a node index, or the position in Objects() of a leaf object when count[i] is 1.
+		 * \details Unused lanes have count 0, child kNone and NaN bounds.
+		 */
+		struct Node
+		{
+			Box3Packet<T, 4> bounds;
+			std::uint32_t child[4];
+			std::uint32_t count[4];
+		};
+
+		Bvh(); /// Empty hierarchy
+		explicit Bvh(const std::vector<Box3<T>>& bounds);
+
+		void Build(const std::vector<Box3<T>>& bounds);
+
+		/**
+		 * Update the node boxes to new bounds of the same objects, keeping the tree.
+		 * \details One pass over the nodes in reverse order, children being stored after their parent.
+		 *	Queries stay exact but slow down as objects drift from where the tree was built.
+		 */
+		void Refit(const std::vector<Box3<T>>& bounds);
+
+		size_t NbObjects() const;
+		size_t NbNodes() const;
+		Box3<T> Bounds() const;
+		const std::vector<Node, Allocator<Node>>& Nodes() const;
+		const std::vector<std::uint32_t>& Objects() const; /// Object indices in leaf order
+
+		/**
+		 * Call function(object, tMax) for each object whose box the ray origin + t * direction enters before tMax.
+		 * \details Children are visited nearest first and the function may lower tMax, so a closest hit
+		 *	query only reaches the objects in front of the best hit found so far.
+		 */
+		template <typename Function>
+		void Ray(const Vec3<T>& origin, const Vec3<T>& direction, T tMax, Function function) const;
+
+		template <typename Function>
+		void Overlap(const Box3<T>& box, Function function) const; /// Call function(object) for each box overlapping box
+		void Overlap(const Box3<T>& box, std::vector<std::uint32_t>& objects) const; /// Append the objects overlapping box
+
+		/**
+		 * Object minimizing squaredDistance(object), kNone when none is below maxSquaredDistance.
+		 * \details Best first search: squaredDistance must not be lower than the squared distance
+		 *	from point to the box of the object. maxSquaredDistance receives the best distance.
+		 */
+		template <typename Distance>
+		std::uint32_t Nearest(const Vec3<T>& point, Distance squaredDistance, T& maxSquaredDistance) const;
+		std::uint32_t Nearest(const Vec3<T>& point, const std::vector<Box3<T>>& bounds) const; /// Object with the nearest box in bounds
+
+		static T SquaredDistance(const Box3<T>& box, const Vec3<T>& point);
+
+	private:
+		static const unsigned kBins = 16;
+		static const std::uint32_t kMaxLeafSize = 4; /// Objects of a binary leaf, spread over the lanes of one node
+		static const size_t kParallelBinning = 1 << 15;
+		static const size_t kGrainSize = 1 << 12;
+
+		struct Bin
+		{
+			Box3<T> bounds;
+			Box3<T> centroids;
+			std::uint32_t count = 0;
+		};
+
+		struct BuildNode
+		{
+			Box3<T> bounds;
+			std::uint32_t left; /// kNone for a leaf
+			std::uint32_t right;
+			std::uint32_t first;
+			std::uint32_t count;
+		};
+
+		struct Task
+		{
+			std::uint32_t node;
+			Box3<T> centroids;
+		};
+
+		struct Entry
+		{
+			std::uint32_t child;
+			std::uint32_t count;
+			T distance;
+		};
+
+		static T Component(const Vec3<T>& v, unsigned axis);
+		static Vec3<T> Centroid(const Box3<T>& box);
+		static unsigned BinIndex(T value, T min, T scale);
+
+		void BinRange(const std::vector<Box3<T>>& bounds, const ScratchVector<Vec3<T>>& centroids,
+			std::uint32_t first, std::uint32_t last, unsigned axis, T min, T scale, Bin* bins) const;
+		/**
+		 * Split the binary node of current in two, pushing its children to tree and their tasks to tasks.
+		 * \details Leaves of kMaxLeafSize objects or less are left alone. Nodes of kParallelBinning objects or more
+		 *	are binned and partitioned over the hardware threads.
+		 */
+		void SplitNode(const std::vector<Box3<T>>& bounds, const ScratchVector<Vec3<T>>& centroids,
+			const Task& current, ScratchVector<BuildNode>& tree, ScratchVector<Task>& tasks);
+		std::uint32_t AddNode();
+		void Collapse(const std::vector<Box3<T>>& bounds, const ScratchVector<BuildNode>& tree);
+		Box3<T> NodeBounds(std::uint32_t node) const;
+
+		std::vector<Node, Allocator<Node>> mNodes;
+		std::vector<std::uint32_t> mObjects;
+	};
+
+	template <typename T>
+	const std::uint32_t Bvh<T>::kNone;
+
+	template <typename T>
+	Bvh<T>::Bvh()
+		: mNodes(Allocator<Node>(NewDeleteResource())) {
+	}
+
+	template <typename T>
+	Bvh<T>::Bvh(const std::vector<Box3<T>>& bounds)
+		: mNodes(Allocator<Node>(NewDeleteResource())) {
+		Build(bounds);
+	}
+
+	template <typename T>
+	void Bvh<T>::Build (const std::vector<Box3<T>>& bounds) {
+		mNodes.clear();
+		mObjects.resize(bounds.size());
+		if (bounds.empty())
+		{
+			return;
+		}
+		if (bounds.size() >= kNone)
+		{
+			throw std::invalid_argument("Too many objects for 32 bits indices");
+		}
+
+		// Centroids, and the bounds of the boxes and of the centroids, one partial result per chunk
+		ScratchVector<Vec3<T>> centroids(bounds.size());
+		ScratchVector<Box3<T>> chunkBounds(2 * ParallelChunks(bounds.size(), kGrainSize));
+		ParallelForChunks(bounds.size(), kGrainSize, [&](const size_t chunk, const size_t first, const size_t last) {
+			for (size_t i = first; i < last; ++i)
+			{
+				mObjects[i] = std::uint32_t(i);
+				centroids[i] = Centroid(bounds[i]);
+				chunkBounds[2 * chunk].Merge(bounds[i]);
+				chunkBounds[2 * chunk + 1].Merge(centroids[i]);
+			}
+		});
+
+		BuildNode root;
+		Task task;
+		root.left = root.right = kNone;
+		root.first = 0;
+		root.count = std::uint32_t(bounds.size());
+		task.node = 0;
+		for (size_t i = 0; i < chunkBounds.size(); i += 2)
+		{
+			root.bounds.Merge(chunkBounds[i]);
+			task.centroids.Merge(chunkBounds[i + 1]);
+		}
+
+		// Nodes too large for one thread are split one at a time, each binned and partitioned over the hardware threads
+		ScratchVector<BuildNode> tree(1, root);
+		ScratchVector<Task> tasks(1, task);
+		ScratchVector<Task> subtrees;
+		tree.reserve(bounds.size() / 2 + 1);
+		while (!tasks.empty())
+		{
+			const Task current = tasks.back();
+			tasks.pop_back();
+			if (tree[current.node].count < kParallelBinning)
+			{
+				subtrees.push_back(current);
+				continue;
+			}
+			SplitNode(bounds, centroids, current, tree, tasks);
+		}
+
+		// The subtrees below them are built in parallel, each in its own array, then appended in order
+		ScratchVector<ScratchVector<BuildNode>> subtreeNodes(subtrees.size());
+		ParallelFor(subtrees.size(), 1, [&](const size_t first, const size_t last) {
+			for (size_t s = first; s < last; ++s)
+			{
+				auto& nodes = subtreeNodes[s];
+				nodes.assign(1, tree[subtrees[s].node]);
+				ScratchVector<Task> subtreeTasks(1, Task{ 0, subtrees[s].centroids });
+				while (!subtreeTasks.empty())
+				{
+					const Task current = subtreeTasks.back();
+					subtreeTasks.pop_back();
+					SplitNode(bounds, centroids, current, nodes, subtreeTasks);
+				}
+			}
+		});
+
+		for (size_t s = 0; s < subtrees.size(); ++s)
+		{
+			// Node i > 0 of a subtree goes to base + i, its root replaces the node it was built from
+			const auto& nodes = subtreeNodes[s];
+			const auto base = std::uint32_t(tree.size() - 1);
+			const auto remap = [base](BuildNode node) {
+				if (node.left != kNone)
+				{
+					node.left += base;
+					node.right += base;
+				}
+				return node;
+			};
+			tree[subtrees[s].node] = remap(nodes[0]);
+			for (size_t i = 1; i < nodes.size(); ++i)
+			{
+				tree.push_back(remap(nodes[i]));
+			}
+		}
+
+		Collapse(bounds, tree);
+	}
+
+	template <typename T>
+	void Bvh<T>::Refit (const std::vector<Box3<T>>& bounds) {
+		if (bounds.size() != mObjects.size())
+		{
+			throw std::invalid_argument("Refit needs the bounds of the objects the hierarchy was built on");
+		}
+
+		for (size_t n = mNodes.size(); n-- > 0;)
+		{
+			auto& node = mNodes[n];
+			for (unsigned i = 0; i < 4; ++i)
+			{
+				Box3<T> box;
+				if (node.count[i] > 0)
+				{
+					box = bounds[mObjects[node.child[i]]];
+				}
+				else if (node.child[i] != kNone)
+				{
+					box = NodeBounds(node.child[i]);
+				}
+				else
+				{
+					continue;
+				}
+				node.bounds.Set(i, box);
+			}
+		}
+	}
+
+	template <typename T>
+	size_t Bvh<T>::NbObjects () const {
+		return mObjects.size();
+	}
+
+	template <typename T>
+	size_t Bvh<T>::NbNodes () const {
+		return mNodes.size();
+	}
+
+	template <typename T>
+	Box3<T> Bvh<T>::Bounds () const {
+		return mNodes.empty() ? Box3<T>() : NodeBounds(0);
+	}
+
+	template <typename T>
+	const std::vector<typename Bvh<T>::Node, Allocator<typename Bvh<T>::Node>>& Bvh<T>::Nodes () const {
+		return mNodes;
+	}
+
+	template <typename T>
+	const std::vector<std::uint32_t>& Bvh<T>::Objects () const {
+		return mObjects;
+	}
+
+	template <typename T>
+	template <typename Function>
+	void Bvh<T>::Ray (const Vec3<T>& origin, const Vec3<T>& direction, T tMax, Function function) const {
+		if (mNodes.empty())
+		{
+			return;
+		}
+
+		const Vec3<T> inverse(T(1) / direction.x, T(1) / direction.y, T(1) / direction.z);
+		ScratchVector<Entry> stack;
+		stack.reserve(64);
+		stack.push_back(Entry{ 0, 0, T(0) });
+
+		while (!stack.empty())
+		{
+			const Entry entry = stack.back();
+			stack.pop_back();
+			if (entry.distance > tMax)
+			{
+				continue;
+			}
+			if (entry.count > 0)
+			{
+				function(mObjects[entry.child], tMax);
+				continue;
+			}
+
+			const auto& node = mNodes[entry.child];
+			T distances[4];
+			const unsigned mask = node.bounds.IntersectRay(origin, inverse, T(0), tMax, distances);
+
+			// Push the hit children farthest first so the nearest is popped next
+			Entry hits[4];
+			unsigned nbHits = 0;
+			for (unsigned i = 0; i < 4; ++i)
+			{
+				if (mask & (1u << i))
+				{
+					Entry hit{ node.child[i], node.count[i], distances[i] };
+					unsigned j = nbHits++;
+					for (; j > 0 && hits[j - 1].distance < hit.distance; --j)
+					{
+						hits[j] = hits[j - 1];
+					}
+					hits[j] = hit;
+				}
+			}
+			stack.insert(stack.end(), hits, hits + nbHits);
+		}
+	}
+
+	template <typename T>
+	template <typename Function>
+	void Bvh<T>::Overlap (const Box3<T>& box, Function function) const {
+		if (mNodes.empty() || box.IsEmpty())
+		{
+			return;
+		}
+
+		ScratchVector<std::uint32_t> stack(1, 0);
+		while (!stack.empty())
+		{
+			const auto& node = mNodes[stack.back()];
+			stack.pop_back();
+			const unsigned mask = node.bounds.Overlaps(box);
+			for (unsigned i = 0; i < 4; ++i)
+			{
+				if (!(mask & (1u << i)))
+				{
+					continue;
+				}
+				if (node.count[i] == 0)
+				{
+					stack.push_back(node.child[i]);
+					continue;
+				}
+				function(mObjects[node.child[i]]);
+			}
+		}
+	}
+
+	template <typename T>
+	void Bvh<T>::Overlap (const Box3<T>& box, std::vector<std::uint32_t>& objects) const {
+		Overlap(box, [&objects](const std::uint32_t object) {
+			objects.push_back(object);
+		});
+	}
+
+	template <typename T>
+	template <typename Distance>
+	std::uint32_t Bvh<T>::Nearest (const Vec3<T>& point, Distance squaredDistance, T& maxSquaredDistance) const {
+		std::uint32_t nearest = kNone;
+		if (mNodes.empty())
+		{
+			return nearest;
+		}
+
+		const auto farther = [](const Entry& lhs, const Entry& rhs) {
+			return lhs.distance > rhs.distance;
+		};
+		std::priority_queue<Entry, ScratchVector<Entry>, decltype(farther)> queue(farther);
+		queue.push(Entry{ 0, 0, T(0) });
+
+		while (!queue.empty())
+		{
+			const Entry entry = queue.top();
+			queue.pop();
+			if (entry.distance >= maxSquaredDistance)
+			{
+				break;
+			}
+			if (entry.count > 0)
+			{
+				const T distance = squaredDistance(mObjects[entry.child]);
+				if (distance < maxSquaredDistance)
+				{
+					maxSquaredDistance = distance;
+					nearest = mObjects[entry.child];
+				}
+				continue;
+			}
+
+			const auto& node = mNodes[entry.child];
+			for (unsigned i = 0; i < 4; ++i)
+			{
+				if (node.count[i] == 0 && node.child[i] == kNone)
+				{
+					continue;
+				}
+				const T distance = SquaredDistance(node.bounds.Get(i), point);
+				if (distance < maxSquaredDistance)
+				{
+					queue.push(Entry{ node.child[i], node.count[i], distance });
+				}
+			}
+		}
+		return nearest;
+	}
+
+	template <typename T>
+	std::uint32_t Bvh<T>::Nearest (const Vec3<T>& point, const std::vector<Box3<T>>& bounds) const {
+		T maxSquaredDistance = std::numeric_limits<T>::infinity();
+		return Nearest(point, [&](const std::uint32_t object) {
+			return SquaredDistance(bounds[object], point);
+		}, maxSquaredDistance);
+	}
+
+	template <typename T>
+	T Bvh<T>::SquaredDistance (const Box3<T>& box, const Vec3<T>& point) {
+		const T dx = std::max(std::max(box.min.x - point.x, point.x - box.max.x), T(0));
+		const T dy = std::max(std::max(box.min.y - point.y, point.y - box.max.y), T(0));
+		const T dz = std::max(std::max(box.min.z - point.z, point.z - box.max.z), T(0));
+		return dx * dx + dy * dy + dz * dz;
+	}
+
+	template <typename T>
+	T Bvh<T>::Component (const Vec3<T>& v, const unsigned axis) {
+		return axis == 0 ? v.x : axis == 1 ? v.y : v.z;
+	}
+
+	template <typename T>
+	Vec3<T> Bvh<T>::Centroid (const Box3<T>& box) {
+		return Vec3<T>((box.min.x + box.max.x) / 2, (box.min.y + box.max.y) / 2, (box.min.z + box.max.z) / 2);
+	}
+
+	template <typename T>
+	unsigned Bvh<T>::BinIndex (const T value, const T min, const T scale) {
+		const auto index = (value - min) * scale;
+		return index >= T(kBins - 1) ? kBins - 1 : index > T(0) ? unsigned(index) : 0u;
+	}
+
+	template <typename T>
+	void Bvh<T>::SplitNode (const std::vector<Box3<T>>& bounds, const ScratchVector<Vec3<T>>& centroids,
+		const Task& current, ScratchVector<BuildNode>& tree, ScratchVector<Task>& tasks) {
+		const auto first = tree[current.node].first;
+		const auto count = tree[current.node].count;
+		if (count <= kMaxLeafSize)
+		{
+			return;
+		}
+
+		// Bin along the longest axis of the centroid bounds, one set of bins per chunk on large nodes
+		const auto extent = current.centroids.max - current.centroids.min;
+		const unsigned axis = extent.x >= extent.y && extent.x >= extent.z ? 0 : extent.y >= extent.z ? 1 : 2;
+		const auto min = Component(current.centroids.min, axis);
+		const auto scale = kBins / Component(extent, axis);
+
+		T bestCost = std::numeric_limits<T>::max();
+		unsigned bestSplit = kBins;
+		Bin bins[kBins];
+		if (Component(extent, axis) > 0)
+		{
+			if (count < kParallelBinning)
+			{
+				BinRange(bounds, centroids, first, first + count, axis, min, scale, bins);
+			}
+			else
+			{
+				const auto chunks = ParallelChunks(count, kParallelBinning / 4);
+				ScratchVector<Bin> chunkBins(chunks * kBins);
+				ParallelForChunks(count, kParallelBinning / 4, [&](const size_t chunk, const size_t begin, const size_t end) {
+					BinRange(bounds, centroids, std::uint32_t(first + begin), std::uint32_t(first + end), axis, min, scale,
+						&chunkBins[chunk * kBins]);
+				});
+				for (size_t chunk = 0; chunk < chunks; ++chunk)
+				{
+					for (unsigned b = 0; b < kBins; ++b)
+					{
+						const auto& local = chunkBins[chunk * kBins + b];
+						bins[b].bounds.Merge(local.bounds);
+						bins[b].centroids.Merge(local.centroids);
+						bins[b].count += local.count;
+					}
+				}
+			}
+
+			// Lowest count * area sum over the kBins - 1 split planes
+			T rightArea[kBins];
+			std::uint32_t rightCount[kBins];
+			Box3<T> right;
+			std::uint32_t rightTotal = 0;
+			for (unsigned b = kBins - 1; b > 0; --b)
+			{
+				right.Merge(bins[b].bounds);
+				rightTotal += bins[b].count;
+				rightArea[b] = right.SurfaceArea();
+				rightCount[b] = rightTotal;
+			}
+
+			Box3<T> left;
+			std::uint32_t leftTotal = 0;
+			for (unsigned b = 0; b + 1 < kBins; ++b)
+			{
+				left.Merge(bins[b].bounds);
+				leftTotal += bins[b].count;
+				if (leftTotal == 0 || rightCount[b + 1] == 0)
+				{
+					continue;
+				}
+				const T cost = leftTotal * left.SurfaceArea() + rightCount[b + 1] * rightArea[b + 1];
+				if (cost < bestCost)
+				{
+					bestCost = cost;
+					bestSplit = b;
+				}
+			}
+		}
+
+		BuildNode leftNode, rightNode;
+		Task leftTask, rightTask;
+		leftNode.left = leftNode.right = rightNode.left = rightNode.right = kNone;
+		leftNode.first = first;
+		if (bestSplit < kBins)
+		{
+			for (unsigned b = 0; b < kBins; ++b)
+			{
+				auto& node = b <= bestSplit ? leftNode : rightNode;
+				auto& child = b <= bestSplit ? leftTask : rightTask;
+				node.bounds.Merge(bins[b].bounds);
+				child.centroids.Merge(bins[b].centroids);
+			}
+
+			const auto isLeft = [&](const std::uint32_t object) {
+				return BinIndex(Component(centroids[object], axis), min, scale) <= bestSplit;
+			};
+			const auto chunks = count < kParallelBinning ? 1 : ParallelChunks(count, kParallelBinning / 4);
+			if (chunks == 1)
+			{
+				const auto middle = std::partition(mObjects.begin() + first, mObjects.begin() + first + count, isLeft);
+				leftNode.count = std::uint32_t(middle - mObjects.begin()) - first;
+			}
+			else
+			{
+				// Each chunk counts its left objects, then writes both sides at their offsets
+				ScratchVector<std::uint32_t> offsets(chunks + 1, 0);
+				ParallelForChunks(count, kParallelBinning / 4, [&](const size_t chunk, const size_t begin, const size_t end) {
+					offsets[chunk + 1] = std::uint32_t(std::count_if(mObjects.begin() + first + begin, mObjects.begin() + first + end, isLeft));
+				});
+				for (size_t chunk = 0; chunk < chunks; ++chunk)
+				{
+					offsets[chunk + 1] += offsets[chunk];
+				}
+
+				ScratchVector<std::uint32_t> partitioned(count);
+				ParallelForChunks(count, kParallelBinning / 4, [&](const size_t chunk, const size_t begin, const size_t end) {
+					auto left = offsets[chunk];
+					auto right = offsets[chunks] + std::uint32_t(begin) - offsets[chunk];
+					for (auto i = first + std::uint32_t(begin); i < first + end; ++i)
+					{
+						partitioned[isLeft(mObjects[i]) ? left++ : right++] = mObjects[i];
+					}
+				});
+				ParallelFor(count, kParallelBinning / 4, [&](const size_t begin, const size_t end) {
+					std::copy(partitioned.begin() + begin, partitioned.begin() + end, mObjects.begin() + first + begin);
+				});
+				leftNode.count = offsets[chunks];
+			}
+		}
+		else
+		{
+			// Every centroid at the same place: halve the range
+			leftNode.count = count / 2;
+			for (auto i = first; i < first + count; ++i)
+			{
+				auto& node = i < first + leftNode.count ? leftNode : rightNode;
+				node.bounds.Merge(bounds[mObjects[i]]);
+			}
+			leftTask.centroids = current.centroids;
+			rightTask.centroids = current.centroids;
+		}
+		rightNode.first = first + leftNode.count;
+		rightNode.count = count - leftNode.count;
+
+		leftTask.node = std::uint32_t(tree.size());
+		rightTask.node = leftTask.node + 1;
+		tree[current.node].left = leftTask.node;
+		tree[current.node].right = rightTask.node;
+		tree.push_back(leftNode);
+		tree.push_back(rightNode);
+		tasks.push_back(rightTask);
+		tasks.push_back(leftTask);
+	}
+
+	template <typename T>
+	void Bvh<T>::BinRange (const std::vector<Box3<T>>& bounds, const ScratchVector<Vec3<T>>& centroids,
+		const std::uint32_t first, const std::uint32_t last, const unsigned axis, const T min, const T scale, Bin* bins) const {
+		for (auto i = first; i < last; ++i)
+		{
+			const auto object = mObjects[i];
+			auto& bin = bins[BinIndex(Component(centroids[object], axis), min, scale)];
+			bin.bounds.Merge(bounds[object]);
+			bin.centroids.Merge(centroids[object]);
+			++bin.count;
+		}
+	}
+
+	template <typename T>
+	void Bvh<T>::Collapse (const std::vector<Box3<T>>& bounds, const ScratchVector<BuildNode>& tree) {
+		// A lane is a binary node, or one object at position first of a binary leaf
+		struct Item
+		{
+			std::uint32_t binary;
+			std::uint32_t object;
+		};
+		const auto area = [&](const Item& item) {
+			return item.object == kNone ? tree[item.binary].bounds.SurfaceArea() : T(-1);
+		};
+
+		// Each node opens its largest binary descendants until they no longer fit in 4 lanes
+		ScratchVector<std::pair<std::uint32_t, std::uint32_t>> stack(1, std::make_pair(0u, AddNode()));
+		while (!stack.empty())
+		{
+			const auto binary = stack.back().first;
+			const auto node = stack.back().second;
+			stack.pop_back();
+
+			Item items[4] = { { binary, kNone } };
+			unsigned nbItems = 1;
+			for (;;)
+			{
+				unsigned largest = 4;
+				for (unsigned i = 0; i < nbItems; ++i)
+				{
+					const auto& candidate = tree[items[i].binary];
+					const auto extra = candidate.left != kNone ? 1 : candidate.count - 1;
+					if (items[i].object == kNone && extra > 0 && nbItems + extra <= 4
+						&& (largest == 4 || area(items[i]) > area(items[largest])))
+					{
+						largest = i;
+					}
+				}
+				if (largest == 4)
+				{
+					break;
+				}
+
+				const auto expanded = tree[items[largest].binary];
+				if (expanded.left != kNone)
+				{
+					items[largest].binary = expanded.left;
+					items[nbItems++] = Item{ expanded.right, kNone };
+				}
+				else
+				{
+					items[largest].object = expanded.first;
+					for (auto o = expanded.first + 1; o < expanded.first + expanded.count; ++o)
+					{
+						items[nbItems++] = Item{ items[largest].binary, o };
+					}
+				}
+			}
+
+			for (unsigned i = 0; i < nbItems; ++i)
+			{
+				const auto& child = tree[items[i].binary];
+				const auto object = items[i].object != kNone ? items[i].object
+					: child.left == kNone && child.count == 1 ? child.first : kNone;
+				if (object != kNone)
+				{
+					mNodes[node].bounds.Set(i, bounds[mObjects[object]]);
+					mNodes[node].child[i] = object;
+					mNodes[node].count[i] = 1;
+				}
+				else
+				{
+					const auto index = AddNode();
+					mNodes[node].bounds.Set(i, child.bounds);
+					mNodes[node].child[i] = index;
+					stack.push_back(std::make_pair(items[i].binary, index));
+				}
+			}
+		}
+	}
+
+	template <typename T>
+	std::uint32_t Bvh<T>::AddNode () {
+		Node node;
+		for (unsigned i = 0; i < 4; ++i)
+		{
+			node.child[i] = kNone;
+			node.count[i] = 0;
+		}
+		mNodes.push_back(node);
+		return std::uint32_t(mNodes.size() - 1);
+	}
+
+	template <typename T>
+	Box3<T> Bvh<T>::NodeBounds (const std::uint32_t node) const {
+		Box3<T> box;
+		for (unsigned i = 0; i < 4; ++i)
+		{
+			if (mNodes[node].count[i] > 0 || mNodes[node].child[i] != kNone)
+			{
+				box.Merge(mNodes[node].bounds.Get(i));
+			}
+		}
+		return box;
+	}
+
+	typedef Bvh<float> Bvhf;
+	typedef Bvh<double> Bvhd;
+}
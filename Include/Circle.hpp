@@ -8,19 +8,38 @@
  *  This file is licensed under the MIT License, see https://opensource.org/licenses/MIT
  */
 #pragma once
+#include <vector>
 #include "Vec2.hpp"
 
 namespace Math
 {
+	/**
+	 * Circle stored as its center and squared radius
+	 * \details Built once from three points (circumcircle) or from a center and a radius,
+	 *	so testing a point is a single squared distance comparison.
+	 */
 	class Circle
 	{
 	public:
-		Circle(Math::Vec2d& p1, Math::Vec2d& p2, Math::Vec2d& p3);
-		bool IsPointInside(const Math::Vec2d& point) const;
+		Circle(const Math::Vec2d& p1, const Math::Vec2d& p2, const Math::Vec2d& p3); /// Circumcircle, throws on collinear points
+		Circle(const Math::Vec2d& center, double radius);
+
+		bool IsPointInside(const Math::Vec2d& point) const; /// Strictly inside
+		void IsPointInside(const std::vector<Math::Vec2d>& points, std::vector<unsigned char>& inside) const; /// inside[i] is 1 when points[i] is
+
+		const Math::Vec2d& Center() const;
+		double Radius() const;
+		double SquaredRadius() const;
+
+		/**
+		 * Exact test of point against the circumcircle of p1, p2, p3 in either winding, without building it.
+		 * \details Uses the InCircle and Orient2D predicates, prefer it to the member test for
+		 *	near-degenerate configurations such as Delaunay flips. False for collinear points.
+		 */
+		static bool IsPointInCircumcircle(const Math::Vec2d& p1, const Math::Vec2d& p2, const Math::Vec2d& p3, const Math::Vec2d& point);
 
 	private:
-		Vec2d mP1;
-		Vec2d mP2;
-		Vec2d mP3;
+		Vec2d mCenter;
+		double mSquaredRadius;
 	};
 }
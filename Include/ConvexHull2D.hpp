@@ -0,0 +1,48 @@
+﻿/**
+ * \file ConvexHull2D.hpp
+ * \brief Convex hull of 2D points
+ * \author Elekhyr
+ * \version 1.0
+ * \date 19/10/2026
+ * \copyright Copyright (c) 2017 Thomas Margier
+ *  This file is licensed under the MIT License, see https://opensource.org/licenses/MIT
+ */
+#pragma once
+#include <cstdint>
+#include <vector>
+#include "Vec4.hpp" //todo : fix issue when including vec3 before vec4
+#include "Vec3.hpp"
+#include "Vec2.hpp"
+
+namespace Math
+{
+	/**
+	 * Convex hull of a point set, built by Andrew's monotone chain.
+	 * \details Every turn goes through Orient2D, so the hull is exact: it is strictly convex, collinear
+	 *	points on its edges and duplicates are left out. Points inside the polygon of the extreme
+	 *	points along the axes and the diagonals are discarded before sorting. Large sets are cut into chunks whose hulls
+	 *	are built over the hardware threads, then the hull of their vertices is built.
+	 *
+	 *	Build reuses the memory of the previous build, so a hull kept around does not allocate once
+	 *	it has seen its largest input.
+	 */
+	class ConvexHull2D
+	{
+	public:
+		ConvexHull2D();
+		explicit ConvexHull2D(const std::vector<Vec2d>& points);
+
+		void Build(const std::vector<Vec2d>& points); /// Replace the hull by the one of points
+
+		/**
+		 * Indices in points of the hull vertices, counterclockwise from the lowest x then lowest y.
+		 * \details Duplicate points give their lowest index. Collinear points give the two ends of their segment.
+		 */
+		const std::vector<std::uint32_t>& Vertices() const;
+
+	private:
+		std::vector<std::uint32_t> mVertices;
+		std::vector<std::uint32_t> mOrder; /// Points sorted by x then y, per chunk
+		std::vector<std::uint32_t> mChains; /// Hull of each chunk
+	};
+}
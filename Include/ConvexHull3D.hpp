@@ -0,0 +1,84 @@
+﻿/**
+ * \file ConvexHull3D.hpp
+ * \brief Convex hull of 3D points
+ * \author Elekhyr
+ * \version 1.0
+ * \date 19/10/2026
+ * \copyright Copyright (c) 2017 Thomas Margier
+ *  This file is licensed under the MIT License, see https://opensource.org/licenses/MIT
+ */
+#pragma once
+#include <cstdint>
+#include <vector>
+#include "Vec4.hpp" //todo : fix issue when including vec3 before vec4
+#include "Vec3.hpp"
+
+namespace Math
+{
+	/**
+	 * Convex hull of a point set as a closed triangle mesh, built by quickhull.
+	 * \details Starting from a tetrahedron of extreme points, the furthest point outside a face is
+	 *	added by replacing the faces it sees with a fan joining it to their horizon. Every side test
+	 *	goes through Orient3D, so the hull is exact: no point is outside a face. Points on the plane
+	 *	of a face are not added, but a vertex can end up on the plane of its neighbors, whose faces
+	 *	are then coplanar. Points are copied in Morton order, so that outside sets stay local in memory.
+	 *	Large sets are cut into chunks whose hulls are built over the hardware threads, then the hull
+	 *	of their vertices is built.
+	 *
+	 *	Faces, outside sets and the horizon live in workspaces kept between builds, so a hull kept
+	 *	around does not allocate once it has seen its largest input. Coplanar sets give an empty hull.
+	 */
+	class ConvexHull3D
+	{
+	public:
+		ConvexHull3D();
+		explicit ConvexHull3D(const std::vector<Vec3d>& points);
+
+		void Build(const std::vector<Vec3d>& points); /// Replace the hull by the one of points
+
+		size_t NbTriangles() const;
+		const std::vector<std::uint32_t>& Triangles() const; /// Three indices in points per triangle, counterclockwise seen from outside
+		const std::vector<std::uint32_t>& Vertices() const; /// Indices in points of the hull vertices, increasing
+
+	private:
+		struct Face
+		{
+			std::uint32_t vertices[3];
+			std::uint32_t neighbors[3]; /// Face across the edge from vertices[k] to vertices[k + 1]
+			std::uint32_t outside; /// First point of the outside set, a list linked through Workspace::next
+			std::uint32_t furthest;
+			double distance; /// Of the furthest point, as -Orient3D
+			unsigned char state;
+		};
+
+		struct Workspace
+		{
+			bool Build(const std::vector<Vec3d>& points); /// Hull of points[ids] into triangles, false when they are coplanar
+			bool Initialize();
+			void AddPoint(std::uint32_t face);
+			std::uint32_t AddFace(std::uint32_t a, std::uint32_t b, std::uint32_t c); /// In a free slot first
+			void AddOutside(std::uint32_t face, std::uint32_t point, double distance);
+			void Assign(std::uint32_t point); /// To the outside set of the first created face it is outside of
+
+			std::vector<std::uint32_t> ids; /// Points to build the hull of
+			std::vector<std::uint32_t> triangles; /// Three indices in points per face
+			std::vector<Vec3d> positions; /// Of ids, the hull works on indices in ids
+			std::vector<std::uint32_t> order;
+			std::vector<Face> faces;
+			std::vector<std::uint32_t> free; /// Slots of removed faces
+			std::vector<std::uint32_t> pending; /// Faces that got outside points
+			std::vector<std::uint32_t> next; /// Next point in the same outside set
+			std::vector<std::uint32_t> horizon; /// New face starting at a vertex of the horizon
+			std::vector<std::uint32_t> edges; /// From, to, hidden face and its edge, per horizon edge
+			std::vector<std::uint32_t> orphans; /// Outside points of the removed faces
+			std::vector<std::uint32_t> created;
+			std::vector<std::uint32_t> visible;
+			std::vector<std::uint32_t> hidden;
+			std::vector<std::uint32_t> stack;
+		};
+
+		std::vector<std::uint32_t> mTriangles;
+		std::vector<std::uint32_t> mVertices;
+		std::vector<Workspace> mWorkspaces; /// One per chunk
+	};
+}
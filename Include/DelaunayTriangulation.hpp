@@ -0,0 +1,46 @@
+﻿/**
+ * \file DelaunayTriangulation.hpp
+ * \brief Incremental 2D Delaunay triangulation
+ * \author Elekhyr
+ * \version 1.0
+ * \date 19/10/2026
+ * \copyright Copyright (c) 2017 Thomas Margier
+ *  This file is licensed under the MIT License, see https://opensource.org/licenses/MIT
+ */
+#pragma once
+#include <cstdint>
+#include <vector>
+#include "Vec4.hpp" //todo : fix issue when including vec3 before vec4
+#include "Vec3.hpp"
+#include "Vec2.hpp"
+
+namespace Math
+{
+	/**
+	 * Delaunay triangulation of a point set, built by Bowyer-Watson insertion.
+	 * \details Points are inserted along a Hilbert curve and located by walking from the last
+	 *	inserted triangle, so a location costs O(1) on average and the build O(n log n) for the sort.
+	 *	The hull is closed by ghost triangles sharing one vertex at infinity instead of a super
+	 *	triangle, and every test goes through Orient2D and InCircle, so the result is exact:
+	 *	the hull is convex and no point lies strictly inside a circumcircle.
+	 *
+	 *	The mesh is two arrays of 32 bits indices, 24 bytes per triangle. Halfedge e = 3t + k goes
+	 *	from Triangles()[e] to the next vertex of triangle t. Duplicate points are left out, and a set
+	 *	without three non collinear points gives an empty triangulation.
+	 */
+	class DelaunayTriangulation
+	{
+	public:
+		static const std::uint32_t kNone = 0xFFFFFFFF;
+
+		explicit DelaunayTriangulation(const std::vector<Vec2d>& points);
+
+		size_t NbTriangles() const;
+		const std::vector<std::uint32_t>& Triangles() const; /// Three indices in points per triangle, counterclockwise
+		const std::vector<std::uint32_t>& Halfedges() const; /// Opposite halfedge, kNone on the hull
+
+	private:
+		std::vector<std::uint32_t> mTriangles;
+		std::vector<std::uint32_t> mHalfedges;
+	};
+}
@@ -0,0 +1,140 @@
+﻿/**
+ * \file FixedBezierCurve.hpp
+ * \brief Bezier curves whose degree is known at compile time
+ * \author Elekhyr
+ * \version 1.0
+ * \date 19/10/2026
+ * \copyright Copyright (c) 2017 Thomas Margier
+ *  This file is licensed under the MIT License, see https://opensource.org/licenses/MIT
+ */
+
+#pragma once
+#include <array>
+#include <vector>
+#include "Vec4.hpp" //todo : fix issue when including vec3 before vec4
+#include "Vec3.hpp"
+
+namespace Math
+{
+	/**
+	 * Evaluate a Bezier curve of degree N from homogeneous control points (x*w, y*w, z*w, w).
+	 * \details The generic version runs de Casteljau over a fixed size triangle,
+	 *	degrees 1 to 3 are written out in Bernstein form.
+	 */
+	template <unsigned N, typename T>
+	struct BezierEvaluator
+	{
+		static Vec4<T> Evaluate(const Vec4<T>* points, T u);
+	};
+
+	template <typename T>
+	struct BezierEvaluator<1, T>
+	{
+		static Vec4<T> Evaluate(const Vec4<T>* points, T u);
+	};
+
+	template <typename T>
+	struct BezierEvaluator<2, T>
+	{
+		static Vec4<T> Evaluate(const Vec4<T>* points, T u);
+	};
+
+	template <typename T>
+	struct BezierEvaluator<3, T>
+	{
+		static Vec4<T> Evaluate(const Vec4<T>* points, T u);
+	};
+
+	template <unsigned N, typename T>
+	class FixedBezierCurve
+	{
+		static_assert(std::is_floating_point<T>::value, "T must be a floating point type");
+		static_assert(N > 0, "Degree must be at least 1");
+
+	public:
+		explicit FixedBezierCurve(const std::array<Vec4<T>, N + 1>& controlPoints); /// Control points carry their weight in w
+
+		Vec4<T> ControlPoint(unsigned i) const;
+		Vec3<T> Evaluate(T u) const;
+		std::vector<Vec3<T>> Compute(unsigned nbPoints) const; /// Sampled at the parameters of BezierCurve::ComputeWithDeCasteljau
+
+	private:
+		std::array<Vec4<T>, N + 1> mHomogeneous;
+	};
+
+	template <unsigned N, typename T>
+	Vec4<T> BezierEvaluator<N, T>::Evaluate (const Vec4<T>* points, const T u) {
+		std::array<Vec4<T>, N + 1> temp;
+		for (unsigned i = 0; i <= N; ++i)
+		{
+			temp[i] = points[i];
+		}
+
+		for (unsigned j = 1; j <= N; ++j)
+		{
+			for (unsigned i = 0; i <= N - j; ++i)
+			{
+				temp[i] = (1 - u) * temp[i] + u * temp[i + 1];
+			}
+		}
+		return temp[0];
+	}
+
+	template <typename T>
+	Vec4<T> BezierEvaluator<1, T>::Evaluate (const Vec4<T>* points, const T u) {
+		return (1 - u) * points[0] + u * points[1];
+	}
+
+	template <typename T>
+	Vec4<T> BezierEvaluator<2, T>::Evaluate (const Vec4<T>* points, const T u) {
+		const T s = 1 - u;
+		return (s * s) * points[0] + (2 * s * u) * points[1] + (u * u) * points[2];
+	}
+
+	template <typename T>
+	Vec4<T> BezierEvaluator<3, T>::Evaluate (const Vec4<T>* points, const T u) {
+		const T s = 1 - u;
+		return (s * s * s) * points[0] + (3 * s * s * u) * points[1] + (3 * s * u * u) * points[2] + (u * u * u) * points[3];
+	}
+
+	template <unsigned N, typename T>
+	FixedBezierCurve<N, T>::FixedBezierCurve (const std::array<Vec4<T>, N + 1>& controlPoints) {
+		for (unsigned i = 0; i <= N; ++i)
+		{
+			const auto& point = controlPoints[i];
+			mHomogeneous[i] = Vec4<T>(point.w * point.x, point.w * point.y, point.w * point.z, point.w);
+		}
+	}
+
+	template <unsigned N, typename T>
+	Vec4<T> FixedBezierCurve<N, T>::ControlPoint (const unsigned i) const {
+		const auto& point = mHomogeneous[i];
+		return Vec4<T>(point.x / point.w, point.y / point.w, point.z / point.w, point.w);
+	}
+
+	template <unsigned N, typename T>
+	Vec3<T> FixedBezierCurve<N, T>::Evaluate (const T u) const {
+		const auto point = BezierEvaluator<N, T>::Evaluate(mHomogeneous.data(), u);
+		return Vec3<T>(point.x / point.w, point.y / point.w, point.z / point.w);
+	}
+
+	template <unsigned N, typename T>
+	std::vector<Vec3<T>> FixedBezierCurve<N, T>::Compute (const unsigned nbPoints) const {
+		std::vector<Vec3<T>> curve(nbPoints + 2);
+		const T step = T(1) / (T(nbPoints) + 1);
+
+		curve[0] = Vec3<T>(ControlPoint(0));
+		for (unsigned index = 1; index <= nbPoints; ++index)
+		{
+			curve[index] = Evaluate(index * step);
+		}
+		curve[nbPoints + 1] = Vec3<T>(ControlPoint(N));
+
+		return curve;
+	}
+
+	typedef FixedBezierCurve<2, float> QuadraticBezierf;
+	typedef FixedBezierCurve<2, double> QuadraticBezierd;
+	typedef FixedBezierCurve<3, float> CubicBezierf;
+	typedef FixedBezierCurve<3, double> CubicBezierd;
+}
@@ -0,0 +1,257 @@
+﻿/**
+ * \file Frustum.hpp
+ * \brief View frustum culling
+ * \author Elekhyr
+ * \version 1.0
+ * \date 19/10/2026
+ * \copyright Copyright (c) 2017 Thomas Margier
+ *  This file is licensed under the MIT License, see https://opensource.org/licenses/MIT
+ */
+#pragma once
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <vector>
+#include "Vec4.hpp" //todo : fix issue when including vec3 before vec4
+#include "Vec3.hpp"
+#include "Mat4.hpp"
+#include "Box3.hpp"
+#include "Sphere.hpp"
+#include "Plane.hpp"
+#include "Parallel.hpp"
+#include "MemoryResource.hpp"
+
+namespace Math
+{
+	/**
+	 * Six planes bounding the volume seen by a camera, normals pointing inward.
+	 * \details The planes are read from the rows of the view projection matrix (Gribb and Hartmann):
+	 *	a point p is visible when -w <= x, y, z <= w for (x, y, z, w) = viewProjection * (p, 1),
+	 *	the OpenGL clip volume. They are normalized, so plane values are distances.
+	 *
+	 *	Tests are conservative: an object is only rejected when it lies entirely outside one plane,
+	 *	so a few objects near the corners of the frustum are reported visible.
+	 */
+	template <typename T>
+	class Frustum
+	{
+	public:
+		static_assert(std::is_floating_point<T>::value, "T must be a floating point type");
+
+		enum Side
+		{
+			kLeft,
+			kRight,
+			kBottom,
+			kTop,
+			kNear,
+			kFar,
+			kNbSides
+		};
+
+		Frustum(); /// Everything visible
+		explicit Frustum(const Mat4<T>& viewProjection);
+
+		Plane<T> GetPlane(Side side) const; /// Unit normal pointing inside
+
+		bool Contains(const Vec3<T>& point) const;
+		bool Intersects(const Sphere<T>& sphere) const;
+		bool Intersects(const Box3<T>& box) const;
+
+		/**
+		 * Replace visible by the indices of the visible spheres or boxes, in increasing order.
+		 * \details Objects go through in blocks, every plane being tested on a whole block in a
+		 *	branch free loop the compiler vectorizes. Large arrays are split over the hardware threads.
+		 */
+		void Cull(const SphereArray<T>& spheres, std::vector<std::uint32_t>& visible) const;
+		void Cull(const std::vector<Box3<T>>& boxes, std::vector<std::uint32_t>& visible) const;
+
+	private:
+		static const unsigned kBlockSize = 16;
+		static const size_t kGrainSize = 1 << 14;
+
+		template <typename Kernel>
+		void CullBlocks(size_t count, Kernel kernel, std::vector<std::uint32_t>& visible) const;
+
+		void CullSpheres(const T* x, const T* y, const T* z, const T* radius, unsigned count, unsigned char* inside) const;
+		void CullBoxes(const Box3<T>* boxes, unsigned count, unsigned char* inside) const;
+
+		T mA[kNbSides];
+		T mB[kNbSides];
+		T mC[kNbSides];
+		T mD[kNbSides];
+	};
+
+	template <typename T>
+	Frustum<T>::Frustum() {
+		for (unsigned p = 0; p < kNbSides; ++p)
+		{
+			mA[p] = mB[p] = mC[p] = 0;
+			mD[p] = 1;
+		}
+	}
+
+	template <typename T>
+	Frustum<T>::Frustum(const Mat4<T>& m) {
+		// Row r of the matrix is (v0r, v1r, v2r, v3r): each plane is row 3 plus or minus row 0, 1 or 2
+		const T rows[4][4] = {
+			{ m.v00, m.v10, m.v20, m.v30 },
+			{ m.v01, m.v11, m.v21, m.v31 },
+			{ m.v02, m.v12, m.v22, m.v32 },
+			{ m.v03, m.v13, m.v23, m.v33 }
+		};
+		for (unsigned p = 0; p < kNbSides; ++p)
+		{
+			const T sign = p % 2 == 0 ? T(1) : T(-1);
+			const T* row = rows[p / 2];
+			Math::Plane<T> plane(Vec3<T>(rows[3][0] + sign * row[0], rows[3][1] + sign * row[1], rows[3][2] + sign * row[2]),
+				rows[3][3] + sign * row[3]);
+			plane.Normalize();
+
+			mA[p] = plane.normal.x;
+			mB[p] = plane.normal.y;
+			mC[p] = plane.normal.z;
+			mD[p] = plane.offset;
+		}
+	}
+
+	template <typename T>
+	Plane<T> Frustum<T>::GetPlane (const Side side) const {
+		return Plane<T>(Vec3<T>(mA[side], mB[side], mC[side]), mD[side]);
+	}
+
+	template <typename T>
+	bool Frustum<T>::Contains (const Vec3<T>& point) const {
+		unsigned char inside;
+		const T radius = 0;
+		CullSpheres(&point.x, &point.y, &point.z, &radius, 1, &inside);
+		return inside != 0;
+	}
+
+	template <typename T>
+	bool Frustum<T>::Intersects (const Sphere<T>& sphere) const {
+		unsigned char inside;
+		CullSpheres(&sphere.center.x, &sphere.center.y, &sphere.center.z, &sphere.radius, 1, &inside);
+		return inside != 0;
+	}
+
+	template <typename T>
+	bool Frustum<T>::Intersects (const Box3<T>& box) const {
+		unsigned char inside;
+		CullBoxes(&box, 1, &inside);
+		return inside != 0;
+	}
+
+	template <typename T>
+	void Frustum<T>::Cull (const SphereArray<T>& spheres, std::vector<std::uint32_t>& visible) const {
+		const T* x = spheres.X().data();
+		const T* y = spheres.Y().data();
+		const T* z = spheres.Z().data();
+		const T* radius = spheres.Radius().data();
+		CullBlocks(spheres.Size(), [&](const size_t first, const unsigned count, unsigned char* inside) {
+			CullSpheres(x + first, y + first, z + first, radius + first, count, inside);
+		}, visible);
+	}
+
+	template <typename T>
+	void Frustum<T>::Cull (const std::vector<Box3<T>>& boxes, std::vector<std::uint32_t>& visible) const {
+		CullBlocks(boxes.size(), [&](const size_t first, const unsigned count, unsigned char* inside) {
+			CullBoxes(boxes.data() + first, count, inside);
+		}, visible);
+	}
+
+	template <typename T>
+	template <typename Kernel>
+	void Frustum<T>::CullBlocks (const size_t count, Kernel kernel, std::vector<std::uint32_t>& visible) const {
+		static_assert(kBlockSize <= 32, "The visibility of a block must fit a 32 bits mask");
+
+		// Every chunk keeps a visibility mask per block and counts its visible objects, then writes
+		//	their indices from its offset in visible, so they come out in increasing order
+		const size_t nbBlocks = (count + kBlockSize - 1) / kBlockSize;
+		const size_t grainSize = kGrainSize / kBlockSize;
+		ScratchVector<std::uint32_t> masks(nbBlocks);
+		ScratchVector<size_t> offsets(ParallelChunks(nbBlocks, grainSize) + 1, 0);
+		ParallelForChunks(nbBlocks, grainSize, [&](const size_t chunk, const size_t first, const size_t last) {
+			unsigned char inside[kBlockSize];
+			size_t nbVisible = 0;
+			for (size_t block = first; block < last; ++block)
+			{
+				const auto blockSize = unsigned(std::min<size_t>(kBlockSize, count - block * kBlockSize));
+				kernel(block * kBlockSize, blockSize, inside);
+				std::uint32_t mask = 0;
+				for (unsigned i = 0; i < blockSize; ++i)
+				{
+					mask |= std::uint32_t(inside[i] != 0) << i;
+					nbVisible += inside[i] != 0;
+				}
+				masks[block] = mask;
+			}
+			offsets[chunk + 1] = nbVisible;
+		});
+
+		for (size_t chunk = 1; chunk < offsets.size(); ++chunk)
+		{
+			offsets[chunk] += offsets[chunk - 1];
+		}
+		visible.resize(offsets.back());
+		ParallelForChunks(nbBlocks, grainSize, [&](const size_t chunk, const size_t first, const size_t last) {
+			auto* indices = visible.data() + offsets[chunk];
+			for (size_t block = first; block < last; ++block)
+			{
+				for (std::uint32_t mask = masks[block], i = 0; mask != 0; mask >>= 1, ++i)
+				{
+					if (mask & 1)
+					{
+						*indices++ = std::uint32_t(block * kBlockSize + i);
+					}
+				}
+			}
+		});
+	}
+
+	template <typename T>
+	void Frustum<T>::CullSpheres (const T* x, const T* y, const T* z, const T* radius, const unsigned count,
+		unsigned char* inside) const {
+		for (unsigned i = 0; i < count; ++i)
+		{
+			inside[i] = radius[i] >= 0;
+		}
+		for (unsigned p = 0; p < kNbSides; ++p)
+		{
+			const T a = mA[p], b = mB[p], c = mC[p], d = mD[p];
+			for (unsigned i = 0; i < count; ++i)
+			{
+				inside[i] &= a * x[i] + b * y[i] + c * z[i] + d >= -radius[i];
+			}
+		}
+	}
+
+	template <typename T>
+	void Frustum<T>::CullBoxes (const Box3<T>* boxes, const unsigned count, unsigned char* inside) const {
+		// Center and half size of the block: the box is outside a plane when its center is farther
+		//	than the projection of the half size on the normal
+		T cx[kBlockSize], cy[kBlockSize], cz[kBlockSize], ex[kBlockSize], ey[kBlockSize], ez[kBlockSize];
+		for (unsigned i = 0; i < count; ++i)
+		{
+			cx[i] = (boxes[i].min.x + boxes[i].max.x) / 2;
+			cy[i] = (boxes[i].min.y + boxes[i].max.y) / 2;
+			cz[i] = (boxes[i].min.z + boxes[i].max.z) / 2;
+			ex[i] = (boxes[i].max.x - boxes[i].min.x) / 2;
+			ey[i] = (boxes[i].max.y - boxes[i].min.y) / 2;
+			ez[i] = (boxes[i].max.z - boxes[i].min.z) / 2;
+			inside[i] = (ex[i] >= 0) & (ey[i] >= 0) & (ez[i] >= 0);
+		}
+		for (unsigned p = 0; p < kNbSides; ++p)
+		{
+			const T a = mA[p], b = mB[p], c = mC[p], d = mD[p];
+			const T absA = std::abs(a), absB = std::abs(b), absC = std::abs(c);
+			for (unsigned i = 0; i < count; ++i)
+			{
+				inside[i] &= a * cx[i] + b * cy[i] + c * cz[i] + d >= -(absA * ex[i] + absB * ey[i] + absC * ez[i]);
+			}
+		}
+	}
+
+	typedef Frustum<float> Frustumf;
+	typedef Frustum<double> Frustumd;
+}
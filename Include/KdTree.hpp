@@ -0,0 +1,409 @@
+﻿/**
+ * \file KdTree.hpp
+ * \brief Implicit k-d tree for nearest neighbor queries on points
+ * \author Elekhyr
+ * \version 1.0
+ * \date 19/10/2026
+ * \copyright Copyright (c) 2017 Thomas Margier
+ *  This file is licensed under the MIT License, see https://opensource.org/licenses/MIT
+ */
+#pragma once
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <stdexcept>
+#include <vector>
+#include "Vec4.hpp" //todo : fix issue when including vec3 before vec4
+#include "Vec3.hpp"
+#include "Box3.hpp"
+#include "MemoryResource.hpp"
+#include "Parallel.hpp"
+
+namespace Math
+{
+	/**
+	 * Balanced k-d tree over a fixed set of points, for exact nearest and k nearest queries.
+	 * \details The tree has no node: the points are reordered so that the node of a range of the array
+	 *	is its middle point, the points before it forming the left subtree and the points after it the
+	 *	right one. Only the split axis of each node is stored besides the points. Ranges of at most
+	 *	kLeafSize points are leaves scanned in full.
+	 *
+	 *	The build splits each range at its median along its widest axis with std::nth_element, the
+	 *	first levels one after the other with their ranges spread over the hardware threads, then the
+	 *	subtrees below them in parallel. Batched queries spread the query points over the hardware threads.
+	 *	Points are referred to by their index in the vector given to Build.
+	 */
+	template <typename T>
+	class KdTree
+	{
+	public:
+		static_assert(std::is_floating_point<T>::value, "T must be a floating point type");
+
+		static const std::uint32_t kNone = 0xFFFFFFFF;
+
+		KdTree(); /// Empty tree
+		explicit KdTree(const std::vector<Vec3<T>>& points);
+
+		void Build(const std::vector<Vec3<T>>& points);
+
+		size_t NbPoints() const;
+		const std::vector<Vec3<T>>& Points() const; /// Points in tree order
+		const std::vector<std::uint32_t>& Indices() const; /// Index of each of Points() in the built vector
+
+		/**
+		 * Point nearest to point within sqrt(maxSquaredDistance), kNone when there is none.
+		 * \details maxSquaredDistance receives the squared distance of the point found.
+		 *	Equally distant points are told apart by their index, the lowest wins.
+		 */
+		std::uint32_t Nearest(const Vec3<T>& point, T& maxSquaredDistance) const;
+		std::uint32_t Nearest(const Vec3<T>& point) const;
+
+		void Nearest(const Vec3<T>& point, unsigned k, std::vector<std::uint32_t>& indices) const; /// Replace indices by the k nearest points, nearest first
+
+		/**
+		 * Nearest point to each of points, and its squared distance.
+		 * \details Queries are spread over the hardware threads. Queries close to each other run faster
+		 *	when they come one after the other.
+		 */
+		void Nearest(const std::vector<Vec3<T>>& points, std::vector<std::uint32_t>& nearest, std::vector<T>& squaredDistances) const;
+
+		/**
+		 * k nearest points to each of points, nearest first.
+		 * \details The neighbors of points[i] are neighbors[i * k] to neighbors[i * k + k - 1],
+		 *	padded with kNone when the tree has less than k points.
+		 */
+		void Nearest(const std::vector<Vec3<T>>& points, unsigned k, std::vector<std::uint32_t>& neighbors) const;
+
+	private:
+		static const std::uint32_t kLeafSize = 8;
+		static const size_t kParallelRanges = 64;
+		static const size_t kGrainSize = 1 << 10;
+		static const unsigned kMaxDepth = 64;
+
+		struct Item
+		{
+			Vec3<T> point;
+			std::uint32_t index;
+		};
+
+		struct Range
+		{
+			std::uint32_t first;
+			std::uint32_t last;
+		};
+
+		struct Candidate
+		{
+			T squaredDistance;
+			std::uint32_t index;
+
+			bool operator<(const Candidate& rhs) const;
+		};
+
+		static T Component(const Vec3<T>& v, unsigned axis);
+
+		void Split(ScratchVector<Item>& items, std::uint32_t first, std::uint32_t last);
+		void BuildRange(ScratchVector<Item>& items, std::uint32_t first, std::uint32_t last);
+
+		/**
+		 * Max heap of the k nearest points within sqrt(maxSquaredDistance).
+		 */
+		void Search(const Vec3<T>& point, unsigned k, T maxSquaredDistance, ScratchVector<Candidate>& best) const;
+
+		std::vector<Vec3<T>> mPoints;
+		std::vector<std::uint32_t> mIndices;
+		std::vector<unsigned char> mAxes; /// Split axis of the node of each point
+	};
+
+	template <typename T>
+	const std::uint32_t KdTree<T>::kNone;
+
+	template <typename T>
+	KdTree<T>::KdTree() {
+	}
+
+	template <typename T>
+	KdTree<T>::KdTree(const std::vector<Vec3<T>>& points) {
+		Build(points);
+	}
+
+	template <typename T>
+	void KdTree<T>::Build (const std::vector<Vec3<T>>& points) {
+		const size_t count = points.size();
+		if (count >= kNone)
+		{
+			throw std::invalid_argument("Too many points for 32 bits indices");
+		}
+
+		ScratchVector<Item> items(count);
+		ParallelFor(count, kGrainSize, [&](const size_t first, const size_t last) {
+			for (size_t i = first; i < last; ++i)
+			{
+				items[i].point = points[i];
+				items[i].index = std::uint32_t(i);
+			}
+		});
+		mAxes.assign(count, 0);
+
+		// First levels: few large ranges, each level waiting for the one above
+		ScratchVector<Range> ranges;
+		if (count > kLeafSize)
+		{
+			ranges.push_back(Range{ 0, std::uint32_t(count) });
+		}
+		while (!ranges.empty() && ranges.size() < kParallelRanges)
+		{
+			ParallelFor(ranges.size(), 1, [&](const size_t first, const size_t last) {
+				for (size_t i = first; i < last; ++i)
+				{
+					Split(items, ranges[i].first, ranges[i].last);
+				}
+			});
+
+			ScratchVector<Range> children;
+			for (const auto& range : ranges)
+			{
+				const auto middle = range.first + (range.last - range.first) / 2;
+				if (middle - range.first > kLeafSize)
+				{
+					children.push_back(Range{ range.first, middle });
+				}
+				if (range.last - middle - 1 > kLeafSize)
+				{
+					children.push_back(Range{ middle + 1, range.last });
+				}
+			}
+			ranges.swap(children);
+		}
+
+		ParallelFor(ranges.size(), 1, [&](const size_t first, const size_t last) {
+			for (size_t i = first; i < last; ++i)
+			{
+				BuildRange(items, ranges[i].first, ranges[i].last);
+			}
+		});
+
+		mPoints.resize(count);
+		mIndices.resize(count);
+		ParallelFor(count, kGrainSize, [&](const size_t first, const size_t last) {
+			for (size_t i = first; i < last; ++i)
+			{
+				mPoints[i] = items[i].point;
+				mIndices[i] = items[i].index;
+			}
+		});
+	}
+
+	template <typename T>
+	size_t KdTree<T>::NbPoints () const {
+		return mPoints.size();
+	}
+
+	template <typename T>
+	const std::vector<Vec3<T>>& KdTree<T>::Points () const {
+		return mPoints;
+	}
+
+	template <typename T>
+	const std::vector<std::uint32_t>& KdTree<T>::Indices () const {
+		return mIndices;
+	}
+
+	template <typename T>
+	std::uint32_t KdTree<T>::Nearest (const Vec3<T>& point, T& maxSquaredDistance) const {
+		ScratchVector<Candidate> best;
+		Search(point, 1, maxSquaredDistance, best);
+		if (best.empty())
+		{
+			return kNone;
+		}
+		maxSquaredDistance = best.front().squaredDistance;
+		return best.front().index;
+	}
+
+	template <typename T>
+	std::uint32_t KdTree<T>::Nearest (const Vec3<T>& point) const {
+		T maxSquaredDistance = std::numeric_limits<T>::infinity();
+		return Nearest(point, maxSquaredDistance);
+	}
+
+	template <typename T>
+	void KdTree<T>::Nearest (const Vec3<T>& point, const unsigned k, std::vector<std::uint32_t>& indices) const {
+		ScratchVector<Candidate> best;
+		Search(point, k, std::numeric_limits<T>::infinity(), best);
+		std::sort_heap(best.begin(), best.end());
+
+		indices.clear();
+		indices.reserve(best.size());
+		for (const auto& candidate : best)
+		{
+			indices.push_back(candidate.index);
+		}
+	}
+
+	template <typename T>
+	void KdTree<T>::Nearest (const std::vector<Vec3<T>>& points, std::vector<std::uint32_t>& nearest, std::vector<T>& squaredDistances) const {
+		nearest.resize(points.size());
+		squaredDistances.resize(points.size());
+		ParallelFor(points.size(), kGrainSize, [&](const size_t first, const size_t last) {
+			ScratchVector<Candidate> best;
+			for (size_t i = first; i < last; ++i)
+			{
+				Search(points[i], 1, std::numeric_limits<T>::infinity(), best);
+				nearest[i] = best.empty() ? kNone : best.front().index;
+				squaredDistances[i] = best.empty() ? std::numeric_limits<T>::infinity() : best.front().squaredDistance;
+			}
+		});
+	}
+
+	template <typename T>
+	void KdTree<T>::Nearest (const std::vector<Vec3<T>>& points, const unsigned k, std::vector<std::uint32_t>& neighbors) const {
+		neighbors.assign(points.size() * k, kNone);
+		ParallelFor(points.size(), kGrainSize, [&](const size_t first, const size_t last) {
+			ScratchVector<Candidate> best;
+			for (size_t i = first; i < last; ++i)
+			{
+				Search(points[i], k, std::numeric_limits<T>::infinity(), best);
+				std::sort_heap(best.begin(), best.end());
+				for (size_t j = 0; j < best.size(); ++j)
+				{
+					neighbors[i * k + j] = best[j].index;
+				}
+			}
+		});
+	}
+
+	template <typename T>
+	bool KdTree<T>::Candidate::operator< (const Candidate& rhs) const {
+		return squaredDistance < rhs.squaredDistance || (squaredDistance == rhs.squaredDistance && index < rhs.index);
+	}
+
+	template <typename T>
+	T KdTree<T>::Component (const Vec3<T>& v, const unsigned axis) {
+		return axis == 0 ? v.x : axis == 1 ? v.y : v.z;
+	}
+
+	template <typename T>
+	void KdTree<T>::Split (ScratchVector<Item>& items, const std::uint32_t first, const std::uint32_t last) {
+		Box3<T> bounds;
+		for (auto i = first; i < last; ++i)
+		{
+			bounds.Merge(items[i].point);
+		}
+		const auto size = bounds.Size();
+		const unsigned axis = size.x >= size.y && size.x >= size.z ? 0 : size.y >= size.z ? 1 : 2;
+
+		const auto middle = first + (last - first) / 2;
+		std::nth_element(items.begin() + first, items.begin() + middle, items.begin() + last, [axis](const Item& lhs, const Item& rhs) {
+			return Component(lhs.point, axis) < Component(rhs.point, axis);
+		});
+		mAxes[middle] = static_cast<unsigned char>(axis);
+	}
+
+	template <typename T>
+	void KdTree<T>::BuildRange (ScratchVector<Item>& items, const std::uint32_t first, const std::uint32_t last) {
+		if (last - first <= kLeafSize)
+		{
+			return;
+		}
+
+		Split(items, first, last);
+		const auto middle = first + (last - first) / 2;
+		BuildRange(items, first, middle);
+		BuildRange(items, middle + 1, last);
+	}
+
+	template <typename T>
+	void KdTree<T>::Search (const Vec3<T>& point, const unsigned k, const T maxSquaredDistance, ScratchVector<Candidate>& best) const {
+		best.clear();
+		if (k == 0 || mPoints.empty())
+		{
+			return;
+		}
+
+		const auto consider = [&](const std::uint32_t position) {
+			const auto delta = mPoints[position] - point;
+			const Candidate candidate{ Dot(delta, delta), mIndices[position] };
+			if (best.size() < k)
+			{
+				if (candidate.squaredDistance <= maxSquaredDistance)
+				{
+					best.push_back(candidate);
+					std::push_heap(best.begin(), best.end());
+				}
+			}
+			else if (candidate < best.front())
+			{
+				std::pop_heap(best.begin(), best.end());
+				best.back() = candidate;
+				std::push_heap(best.begin(), best.end());
+			}
+		};
+		const auto reach = [&]() {
+			return best.size() < k ? maxSquaredDistance : best.front().squaredDistance;
+		};
+
+		// Far sides left behind, with a lower bound of their squared distance to point made of the
+		//	distance from point to the region along each axis (incremental distance of Arya and Mount)
+		struct Pending
+		{
+			std::uint32_t first;
+			std::uint32_t last;
+			T squaredDistance;
+			T offsets[3];
+		};
+		Pending stack[kMaxDepth];
+		unsigned size = 0;
+
+		// Rounding can put the bound a few ulps above the computed distance of a point it bounds, which
+		//	would prune a point tied with the best one, so it is scaled down before any comparison
+		const T boundScale = 1 - 16 * std::numeric_limits<T>::epsilon();
+		stack[size++] = Pending{ 0, std::uint32_t(mPoints.size()), 0, { 0, 0, 0 } };
+
+		while (size > 0)
+		{
+			const auto pending = stack[--size];
+			if (pending.squaredDistance * boundScale > reach())
+			{
+				continue;
+			}
+
+			auto first = pending.first;
+			auto last = pending.last;
+			while (last - first > kLeafSize)
+			{
+				const auto middle = first + (last - first) / 2;
+				consider(middle);
+
+				const auto axis = mAxes[middle];
+				const T difference = Component(point, axis) - Component(mPoints[middle], axis);
+				const T squaredDistance = pending.squaredDistance - pending.offsets[axis] * pending.offsets[axis] + difference * difference;
+				if (squaredDistance * boundScale <= reach())
+				{
+					Pending far = pending;
+					far.first = difference < 0 ? middle + 1 : first;
+					far.last = difference < 0 ? last : middle;
+					far.squaredDistance = squaredDistance;
+					far.offsets[axis] = difference;
+					stack[size++] = far;
+				}
+				if (difference < 0)
+				{
+					last = middle;
+				}
+				else
+				{
+					first = middle + 1;
+				}
+			}
+
+			for (auto position = first; position < last; ++position)
+			{
+				consider(position);
+			}
+		}
+	}
+
+	typedef KdTree<float> KdTreef;
+	typedef KdTree<double> KdTreed;
+}
@@ -563,25 +563,26 @@ namespace Math
 
 	template <typename T>
 	Mat4<T>& Mat4<T>::operator*= (const Mat4& rhs) {
-		T tv00 = v00*rhs.v00 + v10 * rhs.v01 + v20 * rhs.v02 + v30 * v03;
-		T tv10 = v00*rhs.v10 + v10 * rhs.v11 + v20 * rhs.v12 + v30 * v13;
-		T tv20 = v00*rhs.v20 + v10 * rhs.v21 + v20 * rhs.v22 + v30 * v23;
-		T tv30 = v00*rhs.v20 + v10 * rhs.v21 + v20 * rhs.v22 + v30 * v33;
-
-		T tv01 = v01*rhs.v00 + v11 * rhs.v01 + v21 * rhs.v02 + v31 * v03;
-		T tv11 = v01*rhs.v10 + v11 * rhs.v11 + v21 * rhs.v12 + v31 * v13;
-		T tv21 = v01*rhs.v20 + v11 * rhs.v21 + v21 * rhs.v22 + v31 * v23;
-		T tv31 = v01*rhs.v20 + v11 * rhs.v21 + v21 * rhs.v22 + v31 * v33;
-
-		T tv02 = v02*rhs.v00 + v12 * rhs.v01 + v22 * rhs.v02 + v32 * v03;
-		T tv12 = v02*rhs.v10 + v12 * rhs.v11 + v22 * rhs.v12 + v32 * v13;
-		T tv22 = v02*rhs.v20 + v12 * rhs.v21 + v22 * rhs.v22 + v32 * v23;
-		T tv32 = v02*rhs.v20 + v12 * rhs.v21 + v22 * rhs.v22 + v32 * v33;
-
-		T tv03 = v02*rhs.v00 + v12 * rhs.v01 + v22 * rhs.v02 + v33 * v03;
-		T tv13 = v02*rhs.v10 + v12 * rhs.v11 + v22 * rhs.v12 + v33 * v13;
-		T tv23 = v02*rhs.v20 + v12 * rhs.v21 + v22 * rhs.v22 + v33 * v23;
-		T tv33 = v02*rhs.v20 + v12 * rhs.v21 + v22 * rhs.v22 + v33 * v33;
+		// Column c of the product is this matrix applied to column c of rhs
+		T tv00 = v00 * rhs.v00 + v10 * rhs.v01 + v20 * rhs.v02 + v30 * rhs.v03;
+		T tv01 = v01 * rhs.v00 + v11 * rhs.v01 + v21 * rhs.v02 + v31 * rhs.v03;
+		T tv02 = v02 * rhs.v00 + v12 * rhs.v01 + v22 * rhs.v02 + v32 * rhs.v03;
+		T tv03 = v03 * rhs.v00 + v13 * rhs.v01 + v23 * rhs.v02 + v33 * rhs.v03;
+
+		T tv10 = v00 * rhs.v10 + v10 * rhs.v11 + v20 * rhs.v12 + v30 * rhs.v13;
+		T tv11 = v01 * rhs.v10 + v11 * rhs.v11 + v21 * rhs.v12 + v31 * rhs.v13;
+		T tv12 = v02 * rhs.v10 + v12 * rhs.v11 + v22 * rhs.v12 + v32 * rhs.v13;
+		T tv13 = v03 * rhs.v10 + v13 * rhs.v11 + v23 * rhs.v12 + v33 * rhs.v13;
+
+		T tv20 = v00 * rhs.v20 + v10 * rhs.v21 + v20 * rhs.v22 + v30 * rhs.v23;
+		T tv21 = v01 * rhs.v20 + v11 * rhs.v21 + v21 * rhs.v22 + v31 * rhs.v23;
+		T tv22 = v02 * rhs.v20 + v12 * rhs.v21 + v22 * rhs.v22 + v32 * rhs.v23;
+		T tv23 = v03 * rhs.v20 + v13 * rhs.v21 + v23 * rhs.v22 + v33 * rhs.v23;
+
+		T tv30 = v00 * rhs.v30 + v10 * rhs.v31 + v20 * rhs.v32 + v30 * rhs.v33;
+		T tv31 = v01 * rhs.v30 + v11 * rhs.v31 + v21 * rhs.v32 + v31 * rhs.v33;
+		T tv32 = v02 * rhs.v30 + v12 * rhs.v31 + v22 * rhs.v32 + v32 * rhs.v33;
+		T tv33 = v03 * rhs.v30 + v13 * rhs.v31 + v23 * rhs.v32 + v33 * rhs.v33;
 
 		v00 = tv00;
 		v10 = tv10;
@@ -759,6 +760,15 @@ namespace Math
 		return lhs *= rhs;
 	}
 
+	template <typename T>
+	Vec4<T> operator* (const Mat4<T>& lhs, const Vec4<T>& rhs) {
+		return Vec4<T>(
+			lhs.v00 * rhs.x + lhs.v10 * rhs.y + lhs.v20 * rhs.z + lhs.v30 * rhs.w,
+			lhs.v01 * rhs.x + lhs.v11 * rhs.y + lhs.v21 * rhs.z + lhs.v31 * rhs.w,
+			lhs.v02 * rhs.x + lhs.v12 * rhs.y + lhs.v22 * rhs.z + lhs.v32 * rhs.w,
+			lhs.v03 * rhs.x + lhs.v13 * rhs.y + lhs.v23 * rhs.z + lhs.v33 * rhs.w);
+	}
+
 
 	template <typename T>
 	Mat4<T> operator+ (Mat4<T> lhs, const typename std::enable_if<std::is_arithmetic<T>::value, T>::type& rhs) {
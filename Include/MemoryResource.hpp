@@ -0,0 +1,159 @@
+﻿/**
+ * \file MemoryResource.hpp
+ * \brief Allocation hook for temporary geometry buffers
+ * \author Elekhyr
+ * \version 1.0
+ * \date 19/10/2026
+ * \copyright Copyright (c) 2017 Thomas Margier
+ *  This file is licensed under the MIT License, see https://opensource.org/licenses/MIT
+ */
+#pragma once
+#include <cstddef>
+#include <mutex>
+#include <vector>
+
+namespace Math
+{
+	/**
+	 * Source of raw memory, the same role as std::pmr::memory_resource
+	 */
+	class MemoryResource
+	{
+	public:
+		virtual ~MemoryResource();
+
+		virtual void* Allocate(size_t bytes, size_t alignment) = 0;
+		virtual void Deallocate(void* pointer, size_t bytes, size_t alignment) = 0;
+	};
+
+	MemoryResource* NewDeleteResource(); /// Global operator new and delete
+
+	/**
+	 * Resource used for temporary buffers by the routines of this library, on the calling thread.
+	 * \details NewDeleteResource() unless set. ParallelFor runs its chunks with the resource of the
+	 *	calling thread installed on the workers, so parallel routines draw from it as well and a resource
+	 *	installed here must be thread safe. NewDeleteResource and MonotonicArena are.
+	 */
+	MemoryResource* GetScratchResource();
+	MemoryResource* SetScratchResource(MemoryResource* resource); /// Return the previous one
+
+	/**
+	 * Install a scratch resource on the calling thread for the lifetime of the object
+	 */
+	class ScopedScratchResource
+	{
+	public:
+		explicit ScopedScratchResource(MemoryResource* resource);
+		ScopedScratchResource(const ScopedScratchResource&) = delete;
+		ScopedScratchResource& operator=(const ScopedScratchResource&) = delete;
+		~ScopedScratchResource();
+
+	private:
+		MemoryResource* mPrevious;
+	};
+
+	/**
+	 * Frame arena: bumps a pointer through large blocks and frees everything at once.
+	 * \details Deallocate does nothing. Reset rewinds to the first block but keeps every block,
+	 *	so once the arena has seen a frame of a given size the following ones never reach upstream.
+	 *	Allocations take a lock, so the workers of a parallel routine can share the arena.
+	 */
+	class MonotonicArena : public MemoryResource
+	{
+	public:
+		explicit MonotonicArena(size_t blockSize = 64 * 1024, MemoryResource* upstream = NewDeleteResource());
+		MonotonicArena(const MonotonicArena&) = delete;
+		MonotonicArena& operator=(const MonotonicArena&) = delete;
+		~MonotonicArena();
+
+		void* Allocate(size_t bytes, size_t alignment) override;
+		void Deallocate(void* pointer, size_t bytes, size_t alignment) override;
+
+		void Reset(); /// Make every block available again
+		void Release(); /// Give every block back to upstream
+		size_t Capacity() const; /// Bytes held in blocks
+
+	private:
+		struct Block
+		{
+			char* data;
+			size_t size;
+		};
+
+		mutable std::mutex mMutex;
+		size_t mBlockSize;
+		MemoryResource* mUpstream;
+		std::vector<Block> mBlocks;
+		size_t mCurrent;
+		size_t mOffset;
+	};
+
+	/**
+	 * Standard allocator over a MemoryResource, the scratch resource of the constructing thread by default
+	 */
+	template <typename T>
+	class Allocator
+	{
+	public:
+		typedef T value_type;
+
+		Allocator();
+		Allocator(MemoryResource* resource);
+		template <typename U>
+		Allocator(const Allocator<U>& rhs);
+
+		T* allocate(size_t n);
+		void deallocate(T* pointer, size_t n);
+
+		MemoryResource* Resource() const;
+
+	private:
+		MemoryResource* mResource;
+	};
+
+	template <typename T>
+	using ScratchVector = std::vector<T, Allocator<T>>;
+
+	template <typename T>
+	Allocator<T>::Allocator ()
+		: mResource(GetScratchResource()) {
+	}
+
+	template <typename T>
+	Allocator<T>::Allocator (MemoryResource* resource)
+		: mResource(resource) {
+	}
+
+	template <typename T>
+	template <typename U>
+	Allocator<T>::Allocator (const Allocator<U>& rhs)
+		: mResource(rhs.Resource()) {
+	}
+
+	template <typename T>
+	T* Allocator<T>::allocate (const size_t n) {
+		return static_cast<T*>(mResource->Allocate(n * sizeof(T), alignof(T)));
+	}
+
+	template <typename T>
+	void Allocator<T>::deallocate (T* pointer, const size_t n) {
+		mResource->Deallocate(pointer, n * sizeof(T), alignof(T));
+	}
+
+	template <typename T>
+	MemoryResource* Allocator<T>::Resource () const {
+		return mResource;
+	}
+
+	template <typename T, typename U>
+	bool operator==(const Allocator<T>& lhs, const Allocator<U>& rhs)
+	{
+		return lhs.Resource() == rhs.Resource();
+	}
+
+	template <typename T, typename U>
+	bool operator!=(const Allocator<T>& lhs, const Allocator<U>& rhs)
+	{
+		return !(lhs == rhs);
+	}
+}
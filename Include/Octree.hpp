@@ -0,0 +1,731 @@
+﻿/**
+ * \file Octree.hpp
+ * \brief Sparse linear octree of points keyed by Morton codes
+ * \author Elekhyr
+ * \version 1.0
+ * \date 19/10/2026
+ * \copyright Copyright (c) 2017 Thomas Margier
+ *  This file is licensed under the MIT License, see https://opensource.org/licenses/MIT
+ */
+#pragma once
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <stdexcept>
+#include <vector>
+#include "Vec4.hpp" //todo : fix issue when including vec3 before vec4
+#include "Vec3.hpp"
+#include "Box3.hpp"
+#include "Frustum.hpp"
+#include "MemoryResource.hpp"
+#include "Parallel.hpp"
+#include "SpatialSort.hpp"
+
+namespace Math
+{
+	/**
+	 * Octree over a cube holding points, with leaves split when they would hold more than leafCapacity points.
+	 * \details Only the nodes holding points exist. A node has no pointer: it is found in an open addressing
+	 *	table by its key, a 1 followed by the 3 bit octant of each level from the root (the root key is 1, the keys of
+	 *	its children 8 to 15). The octants of a point are the digits of its Morton code, the interleaved
+	 *	bits of its coordinates quantized to 21 bits, so the leaf of a point is found by reading its code
+	 *	3 bits at a time. Removing points merges back the nodes left with leafCapacity points or less.
+	 *
+	 *	A node is 24 bytes: its key, point count, child mask and, for a leaf, a range of slots in one array of
+	 *	point ids. Build lays the leaves out in Morton order without free slots. A leaf that gets full is moved
+	 *	to the end of the array, and once the slots left behind outnumber the others the leaves are laid out
+	 *	again in Morton order, so the ids never take more than about twice their own size.
+	 *
+	 *	Points are referred to by the id Insert returns, or by their index in the vector given to Build.
+	 *	Ids of removed points are reused.
+	 */
+	template <typename T>
+	class Octree
+	{
+	public:
+		static_assert(std::is_floating_point<T>::value, "T must be a floating point type");
+
+		static const unsigned kMaxDepth = 21;
+
+		/**
+		 * Empty octree over the cube of side the largest size of bounds, starting at its minimum.
+		 * \details Throws std::invalid_argument when bounds are empty or flat, leafCapacity is 0 or maxDepth above kMaxDepth.
+		 */
+		explicit Octree(const Box3<T>& bounds, unsigned leafCapacity = 16, unsigned maxDepth = kMaxDepth);
+
+		/**
+		 * Replace the points, point i getting id i.
+		 * \details Morton codes are computed over the hardware threads and sorted, then the nodes are made top down
+		 *	from the sorted codes. Throws std::invalid_argument when a point is outside the cube.
+		 */
+		void Build(const std::vector<Vec3<T>>& points);
+		std::uint32_t Insert(const Vec3<T>& point); /// Id of the new point, throws std::invalid_argument when point is outside the cube
+		bool Remove(std::uint32_t id); /// False when there is no point with this id
+		void Clear();
+
+		Box3<T> Bounds() const; /// Cube of the root
+		size_t NbPoints() const;
+		size_t NbNodes() const;
+		size_t MemoryUsage() const; /// Size in bytes of the points, node table and leaf ranges
+		bool Contains(std::uint32_t id) const; /// A point has this id
+		const Vec3<T>& Point(std::uint32_t id) const;
+
+		template <typename Function>
+		void Range(const Box3<T>& box, Function function) const; /// Call function(id, point) for each point in box
+		void Range(const Box3<T>& box, std::vector<std::uint32_t>& ids) const; /// Append the points in box
+
+		/**
+		 * Call function(id, point) for each point inside frustum.
+		 * \details Nodes outside a plane are skipped and nodes with every corner inside are reported
+		 *	without testing their points.
+		 */
+		template <typename Function>
+		void Visible(const Frustum<T>& frustum, Function function) const;
+		void Visible(const Frustum<T>& frustum, std::vector<std::uint32_t>& ids) const; /// Append the points inside frustum
+
+	private:
+		static const size_t kGrainSize = 1 << 14;
+		static const size_t kMinTableSize = 16;
+
+		struct Node
+		{
+			std::uint64_t key; /// 0 for a free slot of the table
+			std::uint32_t count; /// Points in the subtree
+			std::uint32_t first; /// First slot of the ids of a leaf in mIds
+			std::uint32_t capacity; /// Slots of a leaf in mIds
+			std::uint8_t children; /// Bit i set when child i exists, 0 for a leaf
+		};
+
+		std::uint64_t Morton(const Vec3<T>& point) const;
+		static unsigned Octant(std::uint64_t code, unsigned depth); /// Octant of code at depth, depth 0 being the root
+		Box3<T> ChildBox(const Box3<T>& box, unsigned octant) const;
+
+		// Node table, linear probing. Emplace and Discard move nodes, so pointers do not survive them.
+		Node* Find(std::uint64_t key);
+		const Node* Find(std::uint64_t key) const;
+		Node& Emplace(std::uint64_t key); /// Node of key, made as an empty leaf when there is none
+		void Discard(std::uint64_t key);
+		void Rehash(size_t size);
+
+		// Leaf ranges
+		std::uint32_t Allocate(std::uint32_t capacity); /// First of capacity new slots at the end of mIds
+		void Push(Node& leaf, std::uint32_t id); /// Moving the leaf to the end of mIds when it is full
+		void Compact(); /// Lay the leaves out again in Morton order, when more than half the slots are left behind
+		void CompactNode(std::uint64_t key, std::vector<std::uint32_t>& ids);
+
+		void BuildNode(std::uint64_t key, unsigned depth, const std::uint64_t* codes, std::uint32_t first, std::uint32_t count);
+		void Split(std::uint64_t key, unsigned depth); /// Turn a leaf into an inner node with a leaf per octant of its points
+		void Collapse(std::uint64_t key);
+		void Gather(std::uint64_t key, ScratchVector<std::uint32_t>& ids) const; /// Append the points of a subtree
+		void Erase(std::uint64_t key); /// Remove the nodes below key
+
+		template <typename Function>
+		void ReportAll(std::uint64_t key, Function& function) const;
+		template <typename Function>
+		void RangeNode(std::uint64_t key, const Box3<T>& nodeBox, const Box3<T>& box, Function& function) const;
+		template <typename Function>
+		void VisibleNode(std::uint64_t key, const Box3<T>& nodeBox, const Frustum<T>& frustum, Function& function) const;
+
+		Vec3<T> mMin;
+		T mSize;
+		T mScale; /// Quantization of coordinates to 21 bits
+		unsigned mLeafCapacity;
+		unsigned mMaxDepth;
+		size_t mNbPoints;
+		std::vector<Node> mNodes; /// Open addressing table, a power of two of slots at most 3/4 full
+		size_t mNbNodes;
+		std::vector<std::uint32_t> mIds; /// Ids of the points of each leaf, in the range of the leaf
+		size_t mNbUnused; /// Slots of mIds left behind by moved or removed leaves
+		std::vector<Vec3<T>> mPoints; /// By id, NaN for removed points
+		std::vector<std::uint32_t> mFree; /// Ids of removed points
+	};
+
+	template <typename T>
+	Octree<T>::Octree(const Box3<T>& bounds, const unsigned leafCapacity, const unsigned maxDepth)
+		: mMin(bounds.min), mLeafCapacity(leafCapacity), mMaxDepth(maxDepth), mNbPoints(0), mNbNodes(0), mNbUnused(0) {
+		const auto size = bounds.Size();
+		mSize = std::max(size.x, std::max(size.y, size.z));
+		if (bounds.IsEmpty() || !(mSize > 0))
+		{
+			throw std::invalid_argument("Bounds must have a positive size");
+		}
+		if (leafCapacity == 0 || maxDepth > kMaxDepth)
+		{
+			throw std::invalid_argument("Leaf capacity must be positive and depth at most 21");
+		}
+		mScale = T(1 << kMaxDepth) / mSize;
+		Clear();
+	}
+
+	template <typename T>
+	void Octree<T>::Build (const std::vector<Vec3<T>>& points) {
+		if (points.size() >= 0xFFFFFFFF)
+		{
+			throw std::invalid_argument("Too many points for 32 bits ids");
+		}
+
+		ScratchVector<std::uint64_t> codes(points.size());
+		ScratchVector<std::uint32_t> ids(points.size());
+		const auto bounds = Bounds();
+		ParallelFor(points.size(), kGrainSize, [&](const size_t first, const size_t last) {
+			for (size_t i = first; i < last; ++i)
+			{
+				if (!bounds.Contains(points[i]))
+				{
+					throw std::invalid_argument("Point outside the octree bounds");
+				}
+				codes[i] = Morton(points[i]);
+				ids[i] = std::uint32_t(i);
+			}
+		});
+		RadixSort(codes.data(), ids.data(), codes.size(), 3 * kMaxDepth);
+
+		// The sorted ids are the leaf ranges, one after the other
+		Clear();
+		mPoints = points;
+		mNbPoints = points.size();
+		mIds.assign(ids.begin(), ids.end());
+		BuildNode(1, 0, codes.data(), 0, std::uint32_t(codes.size()));
+	}
+
+	template <typename T>
+	std::uint32_t Octree<T>::Insert (const Vec3<T>& point) {
+		if (!Bounds().Contains(point))
+		{
+			throw std::invalid_argument("Point outside the octree bounds");
+		}
+
+		std::uint32_t id;
+		if (mFree.empty())
+		{
+			if (mPoints.size() >= 0xFFFFFFFF)
+			{
+				throw std::invalid_argument("Too many points for 32 bits ids");
+			}
+			id = std::uint32_t(mPoints.size());
+			mPoints.push_back(point);
+		}
+		else
+		{
+			id = mFree.back();
+			mFree.pop_back();
+			mPoints[id] = point;
+		}
+		++mNbPoints;
+
+		// Down to the leaf of the point, splitting full leaves on the way and making the missing ones
+		const auto code = Morton(point);
+		std::uint64_t key = 1;
+		for (unsigned depth = 0;; ++depth)
+		{
+			auto* node = Find(key);
+			if (node->children == 0)
+			{
+				if (node->count < mLeafCapacity || depth == mMaxDepth)
+				{
+					Push(*node, id);
+					break;
+				}
+				Split(key, depth);
+				node = Find(key);
+			}
+
+			++node->count;
+			const auto octant = Octant(code, depth);
+			const auto child = key << 3 | octant;
+			if (!(node->children & 1 << octant))
+			{
+				node->children |= std::uint8_t(1 << octant);
+				Emplace(child);
+			}
+			key = child;
+		}
+
+		if (mNbUnused > mIds.size() / 2)
+		{
+			Compact();
+		}
+		return id;
+	}
+
+	template <typename T>
+	bool Octree<T>::Remove (const std::uint32_t id) {
+		if (!Contains(id))
+		{
+			return false;
+		}
+
+		// Down to the leaf, remembering the highest node left small enough to become a leaf
+		const auto code = Morton(mPoints[id]);
+		std::uint64_t key = 1;
+		std::uint64_t collapse = 0;
+		for (unsigned depth = 0;; ++depth)
+		{
+			auto* node = Find(key);
+			--node->count;
+			if (node->children == 0)
+			{
+				auto* ids = mIds.data() + node->first;
+				*std::find(ids, ids + node->count, id) = ids[node->count];
+				break;
+			}
+			if (collapse == 0 && node->count <= mLeafCapacity)
+			{
+				collapse = key;
+			}
+			key = key << 3 | Octant(code, depth);
+		}
+
+		if (collapse != 0)
+		{
+			Collapse(collapse);
+		}
+		else if (key != 1 && Find(key)->count == 0)
+		{
+			mNbUnused += Find(key)->capacity;
+			Discard(key);
+			Find(key >> 3)->children &= std::uint8_t(~(1 << (key & 7)));
+		}
+
+		mPoints[id] = Vec3<T>(std::numeric_limits<T>::quiet_NaN(), std::numeric_limits<T>::quiet_NaN(), std::numeric_limits<T>::quiet_NaN());
+		mFree.push_back(id);
+		--mNbPoints;
+		if (mNbUnused > mIds.size() / 2)
+		{
+			Compact();
+		}
+		return true;
+	}
+
+	template <typename T>
+	void Octree<T>::Clear () {
+		mNodes.assign(mNodes.empty() ? kMinTableSize : mNodes.size(), Node());
+		mNbNodes = 0;
+		Emplace(1);
+		mIds.clear();
+		mNbUnused = 0;
+		mPoints.clear();
+		mFree.clear();
+		mNbPoints = 0;
+	}
+
+	template <typename T>
+	Box3<T> Octree<T>::Bounds () const {
+		return Box3<T>(mMin, Vec3<T>(mMin.x + mSize, mMin.y + mSize, mMin.z + mSize));
+	}
+
+	template <typename T>
+	size_t Octree<T>::NbPoints () const {
+		return mNbPoints;
+	}
+
+	template <typename T>
+	size_t Octree<T>::NbNodes () const {
+		return mNbNodes;
+	}
+
+	template <typename T>
+	size_t Octree<T>::MemoryUsage () const {
+		return mPoints.capacity() * sizeof(Vec3<T>) + mFree.capacity() * sizeof(std::uint32_t)
+			+ mNodes.capacity() * sizeof(Node) + mIds.capacity() * sizeof(std::uint32_t);
+	}
+
+	template <typename T>
+	bool Octree<T>::Contains (const std::uint32_t id) const {
+		return id < mPoints.size() && mPoints[id].x == mPoints[id].x;
+	}
+
+	template <typename T>
+	const Vec3<T>& Octree<T>::Point (const std::uint32_t id) const {
+		return mPoints[id];
+	}
+
+	template <typename T>
+	template <typename Function>
+	void Octree<T>::Range (const Box3<T>& box, Function function) const {
+		RangeNode(1, Bounds(), box, function);
+	}
+
+	template <typename T>
+	void Octree<T>::Range (const Box3<T>& box, std::vector<std::uint32_t>& ids) const {
+		Range(box, [&ids](const std::uint32_t id, const Vec3<T>&) {
+			ids.push_back(id);
+		});
+	}
+
+	template <typename T>
+	template <typename Function>
+	void Octree<T>::Visible (const Frustum<T>& frustum, Function function) const {
+		VisibleNode(1, Bounds(), frustum, function);
+	}
+
+	template <typename T>
+	void Octree<T>::Visible (const Frustum<T>& frustum, std::vector<std::uint32_t>& ids) const {
+		Visible(frustum, [&ids](const std::uint32_t id, const Vec3<T>&) {
+			ids.push_back(id);
+		});
+	}
+
+	template <typename T>
+	std::uint64_t Octree<T>::Morton (const Vec3<T>& point) const {
+		// Points on the far faces of the cube go to the last cell
+		const T last = T((1 << kMaxDepth) - 1);
+		const auto x = std::uint32_t(std::min(last, std::max(T(0), (point.x - mMin.x) * mScale)));
+		const auto y = std::uint32_t(std::min(last, std::max(T(0), (point.y - mMin.y) * mScale)));
+		const auto z = std::uint32_t(std::min(last, std::max(T(0), (point.z - mMin.z) * mScale)));
+		return Morton3D(x, y, z);
+	}
+
+	template <typename T>
+	unsigned Octree<T>::Octant (const std::uint64_t code, const unsigned depth) {
+		return unsigned(code >> 3 * (kMaxDepth - 1 - depth)) & 7;
+	}
+
+	template <typename T>
+	Box3<T> Octree<T>::ChildBox (const Box3<T>& box, const unsigned octant) const {
+		const auto center = box.Center();
+		return Box3<T>(
+			Vec3<T>(octant & 4 ? center.x : box.min.x, octant & 2 ? center.y : box.min.y, octant & 1 ? center.z : box.min.z),
+			Vec3<T>(octant & 4 ? box.max.x : center.x, octant & 2 ? box.max.y : center.y, octant & 1 ? box.max.z : center.z));
+	}
+
+	template <typename T>
+	typename Octree<T>::Node* Octree<T>::Find (const std::uint64_t key) {
+		return const_cast<Node*>(static_cast<const Octree*>(this)->Find(key));
+	}
+
+	template <typename T>
+	const typename Octree<T>::Node* Octree<T>::Find (const std::uint64_t key) const {
+		// Fibonacci hashing: siblings differ in their last bits only, the product spreads them
+		const size_t mask = mNodes.size() - 1;
+		for (size_t slot = size_t(key * 0x9E3779B97F4A7C15ull >> 32) & mask;; slot = (slot + 1) & mask)
+		{
+			if (mNodes[slot].key == key)
+			{
+				return &mNodes[slot];
+			}
+			if (mNodes[slot].key == 0)
+			{
+				return nullptr;
+			}
+		}
+	}
+
+	template <typename T>
+	typename Octree<T>::Node& Octree<T>::Emplace (const std::uint64_t key) {
+		if (4 * (mNbNodes + 1) > 3 * mNodes.size())
+		{
+			Rehash(2 * mNodes.size());
+		}
+
+		const size_t mask = mNodes.size() - 1;
+		size_t slot = size_t(key * 0x9E3779B97F4A7C15ull >> 32) & mask;
+		for (; mNodes[slot].key != 0; slot = (slot + 1) & mask)
+		{
+			if (mNodes[slot].key == key)
+			{
+				return mNodes[slot];
+			}
+		}
+
+		auto& node = mNodes[slot];
+		node = Node();
+		node.key = key;
+		++mNbNodes;
+		return node;
+	}
+
+	template <typename T>
+	void Octree<T>::Discard (const std::uint64_t key) {
+		// Backward shift: the nodes after the hole that may go there do, so probes never stop early
+		const size_t mask = mNodes.size() - 1;
+		size_t hole = size_t(Find(key) - mNodes.data());
+		for (size_t slot = (hole + 1) & mask; mNodes[slot].key != 0; slot = (slot + 1) & mask)
+		{
+			const size_t home = size_t(mNodes[slot].key * 0x9E3779B97F4A7C15ull >> 32) & mask;
+			if (((slot - home) & mask) >= ((slot - hole) & mask))
+			{
+				mNodes[hole] = mNodes[slot];
+				hole = slot;
+			}
+		}
+		mNodes[hole] = Node();
+		--mNbNodes;
+	}
+
+	template <typename T>
+	void Octree<T>::Rehash (const size_t size) {
+		std::vector<Node> nodes(size, Node());
+		nodes.swap(mNodes);
+		const size_t mask = mNodes.size() - 1;
+		for (const auto& node : nodes)
+		{
+			if (node.key != 0)
+			{
+				size_t slot = size_t(node.key * 0x9E3779B97F4A7C15ull >> 32) & mask;
+				while (mNodes[slot].key != 0)
+				{
+					slot = (slot + 1) & mask;
+				}
+				mNodes[slot] = node;
+			}
+		}
+	}
+
+	template <typename T>
+	std::uint32_t Octree<T>::Allocate (const std::uint32_t capacity) {
+		if (mIds.size() + capacity >= 0xFFFFFFFF)
+		{
+			throw std::invalid_argument("Too many points for 32 bits ids");
+		}
+		const auto first = std::uint32_t(mIds.size());
+		mIds.resize(mIds.size() + capacity);
+		return first;
+	}
+
+	template <typename T>
+	void Octree<T>::Push (Node& leaf, const std::uint32_t id) {
+		if (leaf.count == leaf.capacity)
+		{
+			// Only leaves at the maximum depth grow past leafCapacity, by doubling
+			const auto capacity = std::max(mLeafCapacity, 2 * leaf.capacity);
+			const auto first = Allocate(capacity);
+			std::copy(mIds.begin() + leaf.first, mIds.begin() + leaf.first + leaf.count, mIds.begin() + first);
+			mNbUnused += leaf.capacity;
+			leaf.first = first;
+			leaf.capacity = capacity;
+		}
+		mIds[leaf.first + leaf.count++] = id;
+	}
+
+	template <typename T>
+	void Octree<T>::Compact () {
+		std::vector<std::uint32_t> ids;
+		ids.reserve(mIds.size() - mNbUnused);
+		CompactNode(1, ids);
+		mIds.swap(ids);
+		mNbUnused = 0;
+	}
+
+	template <typename T>
+	void Octree<T>::CompactNode (const std::uint64_t key, std::vector<std::uint32_t>& ids) {
+		// Leaves keep their capacity, so the next inserts do not move them again
+		auto& node = *Find(key);
+		if (node.children == 0)
+		{
+			const auto first = std::uint32_t(ids.size());
+			ids.insert(ids.end(), mIds.begin() + node.first, mIds.begin() + node.first + node.capacity);
+			node.first = first;
+			return;
+		}
+		for (unsigned octant = 0; octant < 8; ++octant)
+		{
+			if (node.children & 1 << octant)
+			{
+				CompactNode(key << 3 | octant, ids);
+			}
+		}
+	}
+
+	template <typename T>
+	void Octree<T>::BuildNode (const std::uint64_t key, const unsigned depth,
+		const std::uint64_t* codes, const std::uint32_t first, const std::uint32_t count) {
+		auto& node = Emplace(key);
+		node.count = count;
+		if (count <= mLeafCapacity || depth == mMaxDepth)
+		{
+			node.first = first;
+			node.capacity = count;
+			return;
+		}
+
+		// Codes are sorted, so each octant is a contiguous part of the range
+		std::uint8_t children = 0;
+		std::uint32_t begin = first;
+		for (unsigned octant = 0; octant < 8; ++octant)
+		{
+			const auto end = std::uint32_t(std::partition_point(codes + begin, codes + first + count, [depth, octant](const std::uint64_t code) {
+				return Octant(code, depth) <= octant;
+			}) - codes);
+			if (end != begin)
+			{
+				children |= std::uint8_t(1 << octant);
+				BuildNode(key << 3 | octant, depth + 1, codes, begin, end - begin);
+			}
+			begin = end;
+		}
+		Find(key)->children = children;
+	}
+
+	template <typename T>
+	void Octree<T>::Split (const std::uint64_t key, const unsigned depth) {
+		const auto* leaf = Find(key);
+		ScratchVector<std::uint32_t> ids(mIds.begin() + leaf->first, mIds.begin() + leaf->first + leaf->count);
+		mNbUnused += leaf->capacity;
+
+		// A leaf holds at most leafCapacity points, so each child gets a range of that size
+		std::uint8_t children = 0;
+		for (const auto id : ids)
+		{
+			const auto octant = Octant(Morton(mPoints[id]), depth);
+			if (!(children & 1 << octant))
+			{
+				children |= std::uint8_t(1 << octant);
+				const auto first = Allocate(mLeafCapacity);
+				auto& child = Emplace(key << 3 | octant);
+				child.first = first;
+				child.capacity = mLeafCapacity;
+			}
+			auto& child = *Find(key << 3 | octant);
+			mIds[child.first + child.count++] = id;
+		}
+
+		auto& node = *Find(key);
+		node.children = children;
+		node.first = 0;
+		node.capacity = 0;
+	}
+
+	template <typename T>
+	void Octree<T>::Collapse (const std::uint64_t key) {
+		ScratchVector<std::uint32_t> ids;
+		Gather(key, ids);
+		Erase(key);
+
+		const auto first = Allocate(mLeafCapacity);
+		std::copy(ids.begin(), ids.end(), mIds.begin() + first);
+		auto& node = *Find(key);
+		node.children = 0;
+		node.first = first;
+		node.capacity = mLeafCapacity;
+	}
+
+	template <typename T>
+	void Octree<T>::Gather (const std::uint64_t key, ScratchVector<std::uint32_t>& ids) const {
+		const auto& node = *Find(key);
+		ids.insert(ids.end(), mIds.begin() + node.first, mIds.begin() + node.first + (node.children == 0 ? node.count : 0));
+		for (unsigned octant = 0; octant < 8; ++octant)
+		{
+			if (node.children & 1 << octant)
+			{
+				Gather(key << 3 | octant, ids);
+			}
+		}
+	}
+
+	template <typename T>
+	void Octree<T>::Erase (const std::uint64_t key) {
+		const auto children = Find(key)->children;
+		for (unsigned octant = 0; octant < 8; ++octant)
+		{
+			if (children & 1 << octant)
+			{
+				Erase(key << 3 | octant);
+				mNbUnused += Find(key << 3 | octant)->capacity;
+				Discard(key << 3 | octant);
+			}
+		}
+	}
+
+	template <typename T>
+	template <typename Function>
+	void Octree<T>::ReportAll (const std::uint64_t key, Function& function) const {
+		const auto& node = *Find(key);
+		if (node.children == 0)
+		{
+			for (auto slot = node.first; slot < node.first + node.count; ++slot)
+			{
+				function(mIds[slot], mPoints[mIds[slot]]);
+			}
+			return;
+		}
+		for (unsigned octant = 0; octant < 8; ++octant)
+		{
+			if (node.children & 1 << octant)
+			{
+				ReportAll(key << 3 | octant, function);
+			}
+		}
+	}
+
+	template <typename T>
+	template <typename Function>
+	void Octree<T>::RangeNode (const std::uint64_t key, const Box3<T>& nodeBox, const Box3<T>& box, Function& function) const {
+		const auto& node = *Find(key);
+		if (node.count == 0 || !box.Overlaps(nodeBox))
+		{
+			return;
+		}
+		if (box.Contains(nodeBox))
+		{
+			ReportAll(key, function);
+			return;
+		}
+
+		if (node.children == 0)
+		{
+			for (auto slot = node.first; slot < node.first + node.count; ++slot)
+			{
+				const auto id = mIds[slot];
+				if (box.Contains(mPoints[id]))
+				{
+					function(id, mPoints[id]);
+				}
+			}
+			return;
+		}
+		for (unsigned octant = 0; octant < 8; ++octant)
+		{
+			if (node.children & 1 << octant)
+			{
+				RangeNode(key << 3 | octant, ChildBox(nodeBox, octant), box, function);
+			}
+		}
+	}
+
+	template <typename T>
+	template <typename Function>
+	void Octree<T>::VisibleNode (const std::uint64_t key, const Box3<T>& nodeBox, const Frustum<T>& frustum, Function& function) const {
+		const auto& node = *Find(key);
+		if (node.count == 0 || !frustum.Intersects(nodeBox))
+		{
+			return;
+		}
+
+		// The frustum is convex: a box with all its corners inside is inside
+		bool inside = true;
+		for (unsigned corner = 0; corner < 8 && inside; ++corner)
+		{
+			inside = frustum.Contains(Vec3<T>(corner & 4 ? nodeBox.max.x : nodeBox.min.x,
+				corner & 2 ? nodeBox.max.y : nodeBox.min.y, corner & 1 ? nodeBox.max.z : nodeBox.min.z));
+		}
+		if (inside)
+		{
+			ReportAll(key, function);
+			return;
+		}
+
+		if (node.children == 0)
+		{
+			for (auto slot = node.first; slot < node.first + node.count; ++slot)
+			{
+				const auto id = mIds[slot];
+				if (frustum.Contains(mPoints[id]))
+				{
+					function(id, mPoints[id]);
+				}
+			}
+			return;
+		}
+		for (unsigned octant = 0; octant < 8; ++octant)
+		{
+			if (node.children & 1 << octant)
+			{
+				VisibleNode(key << 3 | octant, ChildBox(nodeBox, octant), frustum, function);
+			}
+		}
+	}
+
+	typedef Octree<float> Octreef;
+	typedef Octree<double> Octreed;
+}
\ No newline at end of file
@@ -0,0 +1,81 @@
+﻿/**
+ * \file Parallel.hpp
+ * \brief Split loops over the hardware threads
+ * \author Elekhyr
+ * \version 1.0
+ * \date 19/10/2026
+ * \copyright Copyright (c) 2017 Thomas Margier
+ *  This file is licensed under the MIT License, see https://opensource.org/licenses/MIT
+ */
+#pragma once
+#include <algorithm>
+#include <cstddef>
+
+namespace Math
+{
+	size_t ParallelThreads(); /// Threads parallel loops run on, the calling one included
+
+	/**
+	 * Number of chunks ParallelFor cuts [0, count) into.
+	 * \details At most one chunk per thread and one per grainSize items, count rounded up. ParallelForChunks
+	 *	then gives each chunk count / chunks items rounded up, the last ones getting what is left, so a chunk
+	 *	can hold fewer than grainSize items, or none.
+	 */
+	inline size_t ParallelChunks(size_t count, size_t grainSize)
+	{
+		const size_t chunks = (count + std::max<size_t>(grainSize, 1) - 1) / std::max<size_t>(grainSize, 1);
+		return std::max<size_t>(1, std::min(ParallelThreads(), chunks));
+	}
+
+	namespace ParallelDetail
+	{
+		/**
+		 * Call task(context, chunk) for every chunk of [0, chunks) on the workers and the calling thread.
+		 * \details Returns once every chunk is done, rethrowing the exception of the lowest chunk that threw.
+		 *	Workers are started on the first call and kept until exit, nothing is allocated afterwards.
+		 */
+		void Run(size_t chunks, void (*task)(void*, size_t), void* context);
+	}
+
+	/**
+	 * Call function(chunk, first, last) on contiguous chunks of [0, count), spread over a pool of worker threads.
+	 * \details The calling thread takes chunks too, so calls can be nested. Chunks are the same for a
+	 *	given count and grainSize on a given machine, so per-chunk results can be combined
+	 *	deterministically. Once all are done, the exception of the lowest chunk that threw is rethrown.
+	 */
+	template <typename Function>
+	void ParallelForChunks(size_t count, size_t grainSize, Function function)
+	{
+		const size_t chunks = ParallelChunks(count, grainSize);
+		if (chunks == 1)
+		{
+			function(size_t(0), size_t(0), count);
+			return;
+		}
+
+		struct Context
+		{
+			Function* function;
+			size_t count;
+			size_t chunkSize;
+		};
+		Context context = { &function, count, (count + chunks - 1) / chunks };
+		ParallelDetail::Run(chunks, [](void* data, const size_t chunk) {
+			const auto& context = *static_cast<const Context*>(data);
+			const size_t first = std::min(context.count, chunk * context.chunkSize);
+			const size_t last = std::min(context.count, first + context.chunkSize);
+			(*context.function)(chunk, first, last);
+		}, &context);
+	}
+
+	/**
+	 * Call function(first, last) on contiguous chunks of [0, count), spread over a pool of worker threads.
+	 */
+	template <typename Function>
+	void ParallelFor(size_t count, size_t grainSize, Function function)
+	{
+		ParallelForChunks(count, grainSize, [&function](size_t, size_t first, size_t last) {
+			function(first, last);
+		});
+	}
+}
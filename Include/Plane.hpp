@@ -0,0 +1,261 @@
+﻿/**
+ * \file Plane.hpp
+ * \brief Plane in 3D space
+ * \author Elekhyr
+ * \version 1.0
+ * \date 19/10/2026
+ * \copyright Copyright (c) 2017 Thomas Margier
+ *  This file is licensed under the MIT License, see https://opensource.org/licenses/MIT
+ */
+#pragma once
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+#include <vector>
+#include "Vec4.hpp" //todo : fix issue when including vec3 before vec4
+#include "Vec3.hpp"
+#include "Parallel.hpp"
+#include "MemoryResource.hpp"
+
+namespace Math
+{
+	/**
+	 * Points p with Dot(normal, p) + offset = 0.
+	 * \details The normal points to the front side. Once normalized, SignedDistance is the euclidean
+	 *	distance to the plane, positive in front.
+	 */
+	template <typename T>
+	struct Plane
+	{
+		static_assert(std::is_floating_point<T>::value, "T must be a floating point type");
+
+		enum Side : unsigned char
+		{
+			kFront,
+			kBack,
+			kOn
+		};
+
+		// Constructors
+		Plane(); /// Plane z = 0, facing +z
+		Plane(const Vec3<T>& normal, T offset);
+		Plane(const Vec3<T>& normal, const Vec3<T>& point); /// Plane through point
+
+		/**
+		 * Plane through three points, front side seeing them counterclockwise.
+		 * \details Throws std::invalid_argument when the points are aligned.
+		 */
+		static Plane FromPoints(const Vec3<T>& p1, const Vec3<T>& p2, const Vec3<T>& p3);
+
+		// Functions
+		void Normalize(); /// Unit normal, the plane is unchanged
+		Plane Normalized() const;
+		void Flip(); /// Swap front and back
+
+		T SignedDistance(const Vec3<T>& point) const;
+		Side Classify(const Vec3<T>& point, T epsilon) const; /// kOn within epsilon of the plane
+		Vec3<T> Project(const Vec3<T>& point) const; /// Closest point on the plane, needs a unit normal
+
+		/**
+		 * Signed distance or side of every point, in the same order.
+		 * \details Blocks of points go through a branch free loop the compiler vectorizes, large
+		 *	arrays are split over the hardware threads.
+		 */
+		void SignedDistances(const std::vector<Vec3<T>>& points, std::vector<T>& distances) const;
+		void Classify(const std::vector<Vec3<T>>& points, T epsilon, std::vector<Side>& sides) const;
+
+		/**
+		 * Sort points by side in a single pass, keeping their order.
+		 * \details front, back and on are replaced, points within epsilon of the plane go to on.
+		 */
+		void Split(const std::vector<Vec3<T>>& points, T epsilon,
+			std::vector<Vec3<T>>& front, std::vector<Vec3<T>>& back, std::vector<Vec3<T>>& on) const;
+
+		// Attributes
+		Vec3<T> normal;
+		T offset;
+
+	private:
+		static const unsigned kBlockSize = 64;
+		static const size_t kGrainSize = 1 << 14;
+
+		void Distances(const Vec3<T>* points, unsigned count, T* distances) const;
+	};
+
+	template <typename T>
+	Plane<T>::Plane()
+		: normal(0, 0, 1), offset(0) {
+	}
+
+	template <typename T>
+	Plane<T>::Plane(const Vec3<T>& normal, const T offset)
+		: normal(normal), offset(offset) {
+	}
+
+	template <typename T>
+	Plane<T>::Plane(const Vec3<T>& normal, const Vec3<T>& point)
+		: normal(normal), offset(-Dot(normal, point)) {
+	}
+
+	template <typename T>
+	Plane<T> Plane<T>::FromPoints (const Vec3<T>& p1, const Vec3<T>& p2, const Vec3<T>& p3) {
+		const auto u = p2 - p1;
+		const auto v = p3 - p1;
+		const Vec3<T> normal(u.y * v.z - u.z * v.y, u.z * v.x - u.x * v.z, u.x * v.y - u.y * v.x);
+		if (normal.x == 0 && normal.y == 0 && normal.z == 0)
+		{
+			throw std::invalid_argument("The points are aligned");
+		}
+
+		Plane plane(normal, p1);
+		plane.Normalize();
+		return plane;
+	}
+
+	template <typename T>
+	void Plane<T>::Normalize () {
+		const auto length = T(normal.Length());
+		if (length > 0)
+		{
+			normal /= length;
+			offset /= length;
+		}
+	}
+
+	template <typename T>
+	Plane<T> Plane<T>::Normalized () const {
+		auto plane = *this;
+		plane.Normalize();
+		return plane;
+	}
+
+	template <typename T>
+	void Plane<T>::Flip () {
+		normal *= T(-1);
+		offset = -offset;
+	}
+
+	template <typename T>
+	T Plane<T>::SignedDistance (const Vec3<T>& point) const {
+		return Dot(normal, point) + offset;
+	}
+
+	template <typename T>
+	typename Plane<T>::Side Plane<T>::Classify (const Vec3<T>& point, const T epsilon) const {
+		const T distance = SignedDistance(point);
+		return distance > epsilon ? kFront : distance < -epsilon ? kBack : kOn;
+	}
+
+	template <typename T>
+	Vec3<T> Plane<T>::Project (const Vec3<T>& point) const {
+		return point - normal * SignedDistance(point);
+	}
+
+	template <typename T>
+	void Plane<T>::SignedDistances (const std::vector<Vec3<T>>& points, std::vector<T>& distances) const {
+		distances.resize(points.size());
+		ParallelFor(points.size(), kGrainSize, [&](const size_t first, const size_t last) {
+			for (size_t block = first; block < last; block += kBlockSize)
+			{
+				const auto count = unsigned(std::min<size_t>(kBlockSize, last - block));
+				Distances(points.data() + block, count, distances.data() + block);
+			}
+		});
+	}
+
+	template <typename T>
+	void Plane<T>::Classify (const std::vector<Vec3<T>>& points, const T epsilon, std::vector<Side>& sides) const {
+		sides.resize(points.size());
+		ParallelFor(points.size(), kGrainSize, [&](const size_t first, const size_t last) {
+			T distances[kBlockSize];
+			for (size_t block = first; block < last; block += kBlockSize)
+			{
+				const auto count = unsigned(std::min<size_t>(kBlockSize, last - block));
+				Distances(points.data() + block, count, distances);
+				for (unsigned i = 0; i < count; ++i)
+				{
+					sides[block + i] = distances[i] > epsilon ? kFront : distances[i] < -epsilon ? kBack : kOn;
+				}
+			}
+		});
+	}
+
+	template <typename T>
+	void Plane<T>::Split (const std::vector<Vec3<T>>& points, const T epsilon,
+		std::vector<Vec3<T>>& front, std::vector<Vec3<T>>& back, std::vector<Vec3<T>>& on) const {
+		// Every chunk counts its points on each side, then copies them from its offsets in the results.
+		//	The copy reads the points anyway, so it computes their distances again instead of keeping sides.
+		const size_t chunks = ParallelChunks(points.size(), kGrainSize);
+		ScratchVector<size_t> offsets(3 * (chunks + 1), 0);
+		ParallelForChunks(points.size(), kGrainSize, [&](const size_t chunk, const size_t first, const size_t last) {
+			size_t counts[3] = { 0, 0, 0 };
+			T distances[kBlockSize];
+			for (size_t block = first; block < last; block += kBlockSize)
+			{
+				const auto count = unsigned(std::min<size_t>(kBlockSize, last - block));
+				Distances(points.data() + block, count, distances);
+				for (unsigned i = 0; i < count; ++i)
+				{
+					++counts[distances[i] > epsilon ? kFront : distances[i] < -epsilon ? kBack : kOn];
+				}
+			}
+			std::copy(counts, counts + 3, offsets.begin() + 3 * (chunk + 1));
+		});
+
+		for (size_t i = 3; i < offsets.size(); ++i)
+		{
+			offsets[i] += offsets[i - 3];
+		}
+		front.resize(offsets[3 * chunks + kFront]);
+		back.resize(offsets[3 * chunks + kBack]);
+		on.resize(offsets[3 * chunks + kOn]);
+		ParallelForChunks(points.size(), kGrainSize, [&](const size_t chunk, const size_t first, const size_t last) {
+			Vec3<T>* results[3];
+			results[kFront] = front.data() + offsets[3 * chunk + kFront];
+			results[kBack] = back.data() + offsets[3 * chunk + kBack];
+			results[kOn] = on.data() + offsets[3 * chunk + kOn];
+			T distances[kBlockSize];
+			for (size_t block = first; block < last; block += kBlockSize)
+			{
+				const auto count = unsigned(std::min<size_t>(kBlockSize, last - block));
+				Distances(points.data() + block, count, distances);
+				for (unsigned i = 0; i < count; ++i)
+				{
+					*results[distances[i] > epsilon ? kFront : distances[i] < -epsilon ? kBack : kOn]++ = points[block + i];
+				}
+			}
+		});
+	}
+
+	template <typename T>
+	void Plane<T>::Distances (const Vec3<T>* points, const unsigned count, T* distances) const {
+		const T a = normal.x, b = normal.y, c = normal.z, d = offset;
+		for (unsigned i = 0; i < count; ++i)
+		{
+			distances[i] = a * points[i].x + b * points[i].y + c * points[i].z + d;
+		}
+	}
+
+	//Stream operator
+	template <typename T>
+	std::ostream& operator<<(std::ostream& out, const Plane<T>& plane)
+	{
+		return out << "[" << plane.normal << ", " << plane.offset << "]";
+	}
+
+	// Relational operators
+	template <typename T>
+	bool operator==(const Plane<T>& lhs, const Plane<T>& rhs)
+	{
+		return lhs.normal == rhs.normal && lhs.offset == rhs.offset;
+	}
+
+	template <typename T>
+	bool operator!=(const Plane<T>& lhs, const Plane<T>& rhs)
+	{
+		return !(lhs == rhs);
+	}
+
+	typedef Plane<float> Planef;
+	typedef Plane<double> Planed;
+}
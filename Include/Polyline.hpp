@@ -0,0 +1,219 @@
+﻿/**
+ * \file Polyline.hpp
+ * \brief Polyline simplification
+ * \author Elekhyr
+ * \version 1.0
+ * \date 19/10/2026
+ * \copyright Copyright (c) 2017 Thomas Margier
+ *  This file is licensed under the MIT License, see https://opensource.org/licenses/MIT
+ */
+#pragma once
+#include <algorithm>
+#include <functional>
+#include <queue>
+#include <utility>
+#include <vector>
+#include "Vec4.hpp" //todo : fix issue when including vec3 before vec4
+#include "Vec3.hpp"
+#include "Vec2.hpp"
+#include "MemoryResource.hpp"
+#include "Parallel.hpp"
+
+namespace Math
+{
+	/**
+	 * Simplification of polylines made of Vec2 or Vec3 points, such as tessellated curves.
+	 * \details Both algorithms keep the end points and return the kept points in their original order.
+	 */
+	struct Polyline
+	{
+		/**
+		 * Douglas-Peucker: keep the farthest point from the chord while it is farther than tolerance.
+		 * \details Ranges are handled with an explicit stack. In parallel mode the polyline is cut
+		 *	in one piece per thread and the cut points are kept, so the result stays within
+		 *	tolerance but can differ from the sequential one.
+		 */
+		template <typename Point>
+		static std::vector<Point> SimplifyDouglasPeucker(const std::vector<Point>& polyline, double tolerance, bool parallel = false);
+
+		/**
+		 * Visvalingam-Whyatt: drop the point forming the smallest triangle with its neighbours
+		 *	while that area is below minArea.
+		 */
+		template <typename Point>
+		static std::vector<Point> SimplifyVisvalingam(const std::vector<Point>& polyline, double minArea);
+
+		template <typename Point>
+		static double DistanceToSegment(const Point& point, const Point& a, const Point& b);
+
+		template <typename Point>
+		static double TriangleArea(const Point& a, const Point& b, const Point& c);
+
+	private:
+		static const size_t kParallelGrainSize = 1 << 16;
+
+		template <typename Point>
+		static void MarkDouglasPeucker(const std::vector<Point>& polyline, size_t first, size_t last, double tolerance,
+			ScratchVector<unsigned char>& keep);
+
+		template <typename Point>
+		static std::vector<Point> Kept(const std::vector<Point>& polyline, const ScratchVector<unsigned char>& keep);
+	};
+
+	template <typename Point>
+	std::vector<Point> Polyline::SimplifyDouglasPeucker (const std::vector<Point>& polyline, const double tolerance, const bool parallel) {
+		if (polyline.size() < 3)
+		{
+			return polyline;
+		}
+
+		const size_t last = polyline.size() - 1;
+		ScratchVector<unsigned char> keep(polyline.size(), 0);
+
+		if (!parallel)
+		{
+			MarkDouglasPeucker(polyline, 0, last, tolerance, keep);
+		}
+		else
+		{
+			// Every piece only marks its interior points, the cut points are marked once all are done
+			ScratchVector<size_t> cuts(ParallelChunks(last, kParallelGrainSize), 0);
+			ParallelForChunks(last, kParallelGrainSize, [&](const size_t chunk, const size_t first, const size_t end) {
+				cuts[chunk] = first;
+				MarkDouglasPeucker(polyline, first, end, tolerance, keep);
+			});
+			for (const auto cut : cuts)
+			{
+				keep[cut] = 1;
+			}
+		}
+
+		keep[0] = 1;
+		keep[last] = 1;
+		return Kept(polyline, keep);
+	}
+
+	template <typename Point>
+	std::vector<Point> Polyline::SimplifyVisvalingam (const std::vector<Point>& polyline, const double minArea) {
+		const size_t count = polyline.size();
+		if (count < 3)
+		{
+			return polyline;
+		}
+
+		// Doubly linked list over the remaining points, and a heap of (area, point) with stale entries skipped
+		ScratchVector<size_t> previous(count), next(count);
+		ScratchVector<double> areas(count, 0.0);
+		ScratchVector<unsigned char> keep(count, 1);
+		typedef std::pair<double, size_t> Entry;
+		std::priority_queue<Entry, ScratchVector<Entry>, std::greater<Entry>> heap;
+
+		for (size_t i = 0; i < count; ++i)
+		{
+			previous[i] = i - 1;
+			next[i] = i + 1;
+		}
+		for (size_t i = 1; i + 1 < count; ++i)
+		{
+			areas[i] = TriangleArea(polyline[i - 1], polyline[i], polyline[i + 1]);
+			heap.push(Entry(areas[i], i));
+		}
+
+		while (!heap.empty())
+		{
+			const auto entry = heap.top();
+			heap.pop();
+			const auto i = entry.second;
+			if (!keep[i] || entry.first != areas[i])
+			{
+				continue;
+			}
+			if (entry.first >= minArea)
+			{
+				break;
+			}
+
+			keep[i] = 0;
+			next[previous[i]] = next[i];
+			previous[next[i]] = previous[i];
+
+			// A neighbour never gets a smaller area than the point just removed, so removal order stays monotone
+			const size_t neighbours[2] = { previous[i], next[i] };
+			for (const auto n : neighbours)
+			{
+				if (n == 0 || n == count - 1)
+				{
+					continue;
+				}
+				areas[n] = std::max(entry.first, TriangleArea(polyline[previous[n]], polyline[n], polyline[next[n]]));
+				heap.push(Entry(areas[n], n));
+			}
+		}
+
+		return Kept(polyline, keep);
+	}
+
+	template <typename Point>
+	double Polyline::DistanceToSegment (const Point& point, const Point& a, const Point& b) {
+		const auto ab = b - a;
+		const auto ap = point - a;
+		const double length2 = Dot(ab, ab);
+		const double t = length2 > 0 ? std::min(1.0, std::max(0.0, Dot(ap, ab) / length2)) : 0.0;
+		return (ap - ab * t).Length();
+	}
+
+	template <typename Point>
+	double Polyline::TriangleArea (const Point& a, const Point& b, const Point& c) {
+		// |ab|^2 |ac|^2 - (ab.ac)^2 is the squared norm of the cross product, in any dimension
+		const auto ab = b - a;
+		const auto ac = c - a;
+		const double dot = Dot(ab, ac);
+		const double cross2 = double(Dot(ab, ab)) * double(Dot(ac, ac)) - dot * dot;
+		return 0.5 * std::sqrt(std::max(0.0, cross2));
+	}
+
+	template <typename Point>
+	void Polyline::MarkDouglasPeucker (const std::vector<Point>& polyline, const size_t first, const size_t last,
+		const double tolerance, ScratchVector<unsigned char>& keep) {
+		ScratchVector<std::pair<size_t, size_t>> ranges(1, std::make_pair(first, last));
+
+		while (!ranges.empty())
+		{
+			const auto range = ranges.back();
+			ranges.pop_back();
+
+			double farthest = tolerance;
+			size_t index = range.first;
+			for (size_t i = range.first + 1; i < range.second; ++i)
+			{
+				const auto distance = DistanceToSegment(polyline[i], polyline[range.first], polyline[range.second]);
+				if (distance > farthest)
+				{
+					farthest = distance;
+					index = i;
+				}
+			}
+
+			if (index != range.first)
+			{
+				keep[index] = 1;
+				ranges.push_back(std::make_pair(range.first, index));
+				ranges.push_back(std::make_pair(index, range.second));
+			}
+		}
+	}
+
+	template <typename Point>
+	std::vector<Point> Polyline::Kept (const std::vector<Point>& polyline, const ScratchVector<unsigned char>& keep) {
+		std::vector<Point> simplified;
+		simplified.reserve(std::count(keep.begin(), keep.end(), 1));
+		for (size_t i = 0; i < polyline.size(); ++i)
+		{
+			if (keep[i])
+			{
+				simplified.push_back(polyline[i]);
+			}
+		}
+		return simplified;
+	}
+}
@@ -0,0 +1,29 @@
+﻿/**
+ * \file Predicates.hpp
+ * \brief Robust orientation and in-circle predicates
+ * \author Elekhyr
+ * \version 1.0
+ * \date 19/10/2026
+ * \copyright Copyright (c) 2017 Thomas Margier
+ *  This file is licensed under the MIT License, see https://opensource.org/licenses/MIT
+ */
+#pragma once
+#include "Vec4.hpp" //todo : fix issue when including vec3 before vec4
+#include "Vec3.hpp"
+#include "Vec2.hpp"
+
+namespace Math
+{
+	/**
+	 * Adaptive precision predicates after J. R. Shewchuk, "Adaptive Precision Floating-Point
+	 *	Arithmetic and Fast Robust Geometric Predicates".
+	 * \details Each predicate evaluates its determinant in plain floating point and returns it when
+	 *	it is larger than the forward error bound of that evaluation. Otherwise the determinant is
+	 *	recomputed exactly with floating point expansions. The sign of the result is always exact,
+	 *	its magnitude is only an approximation of the determinant.
+	 */
+	double Orient2D(const Vec2d& a, const Vec2d& b, const Vec2d& c); /// Positive when a, b, c turn counterclockwise
+	double Orient3D(const Vec3d& a, const Vec3d& b, const Vec3d& c, const Vec3d& d); /// Positive when d is below the plane where a, b, c turn counterclockwise
+	double InCircle(const Vec2d& a, const Vec2d& b, const Vec2d& c, const Vec2d& d); /// Positive when d is inside the circle through a, b, c counterclockwise
+	double InSphere(const Vec3d& a, const Vec3d& b, const Vec3d& c, const Vec3d& d, const Vec3d& e); /// Positive when e is inside the sphere through a, b, c, d with Orient3D(a, b, c, d) > 0
+}
@@ -0,0 +1,238 @@
+﻿/**
+ * \file Reductions.hpp
+ * \brief Sum, bounds, centroid and covariance of point arrays
+ * \author Elekhyr
+ * \version 1.0
+ * \date 19/10/2026
+ * \copyright Copyright (c) 2017 Thomas Margier
+ *  This file is licensed under the MIT License, see https://opensource.org/licenses/MIT
+ */
+#pragma once
+#include <algorithm>
+#include <stdexcept>
+#include <vector>
+#include "Vec4.hpp" //todo : fix issue when including vec3 before vec4
+#include "Vec3.hpp"
+#include "Mat3.hpp"
+#include "Box3.hpp"
+#include "MemoryResource.hpp"
+#include "Parallel.hpp"
+
+namespace Math
+{
+	/**
+	 * Reductions of a point array, split over the hardware threads.
+	 * \details Each chunk keeps kLanes independent accumulators per component, a loop the compiler
+	 *	vectorizes, and the partial results are combined in chunk order, so a given array gives the same
+	 *	result on a given machine. Sums are compensated (Kahan-Babuska), so their error does not grow with
+	 *	the number of points. The covariance is taken around the centroid in a second pass.
+	 */
+	template <typename T>
+	Vec3<T> Sum(const std::vector<Vec3<T>>& points);
+	template <typename T>
+	Box3<T> Bounds(const std::vector<Vec3<T>>& points); /// Empty box for no points
+	template <typename T>
+	Vec3<T> Centroid(const std::vector<Vec3<T>>& points); /// Throws std::invalid_argument for no points
+
+	/**
+	 * Population covariance, the mean of (p - center)(p - center)^T.
+	 * \details Without center, the centroid is used. Throws std::invalid_argument for no points.
+	 */
+	template <typename T>
+	Mat3<T> Covariance(const std::vector<Vec3<T>>& points);
+	template <typename T>
+	Mat3<T> Covariance(const std::vector<Vec3<T>>& points, const Vec3<T>& center);
+
+	namespace ReductionsDetail
+	{
+		const size_t kGrainSize = 1 << 14;
+		const unsigned kLanes = 4;
+
+		/**
+		 * Compensated step: sum + compensation is the sum of the added values, to within one rounding of the result.
+		 * \details The rounding error of each addition comes from Knuth's TwoSum, exact whatever the
+		 *	magnitudes, and without the comparison of Neumaier's version that keeps the loop from vectorizing.
+		 */
+		template <typename T>
+		void Add(T& sum, T& compensation, const T value)
+		{
+			const T total = sum + value;
+			const T rounded = total - sum;
+			compensation += (sum - (total - rounded)) + (value - rounded);
+			sum = total;
+		}
+
+		/**
+		 * Compensated sums of the N values function(point, values) writes for each point.
+		 */
+		template <unsigned N, typename T, typename Function>
+		void Sums(const std::vector<Vec3<T>>& points, Function function, T (&sums)[N])
+		{
+			static_assert(std::is_floating_point<T>::value, "T must be a floating point type");
+
+			struct Partial
+			{
+				T sum[N];
+				T compensation[N];
+			};
+			ScratchVector<Partial> partials(ParallelChunks(points.size(), kGrainSize));
+			ParallelForChunks(points.size(), kGrainSize, [&](const size_t chunk, const size_t first, const size_t last) {
+				T sum[N][kLanes], compensation[N][kLanes], values[N][kLanes];
+				std::fill(&sum[0][0], &sum[0][0] + N * kLanes, T(0));
+				std::fill(&compensation[0][0], &compensation[0][0] + N * kLanes, T(0));
+				size_t i = first;
+				for (; i + kLanes <= last; i += kLanes)
+				{
+					for (unsigned lane = 0; lane < kLanes; ++lane)
+					{
+						T value[N];
+						function(points[i + lane], value);
+						for (unsigned k = 0; k < N; ++k)
+						{
+							values[k][lane] = value[k];
+						}
+					}
+					for (unsigned k = 0; k < N; ++k)
+					{
+						for (unsigned lane = 0; lane < kLanes; ++lane)
+						{
+							Add(sum[k][lane], compensation[k][lane], values[k][lane]);
+						}
+					}
+				}
+				for (; i < last; ++i)
+				{
+					T value[N];
+					function(points[i], value);
+					for (unsigned k = 0; k < N; ++k)
+					{
+						Add(sum[k][0], compensation[k][0], value[k]);
+					}
+				}
+
+				auto& partial = partials[chunk];
+				for (unsigned k = 0; k < N; ++k)
+				{
+					partial.sum[k] = T(0);
+					partial.compensation[k] = T(0);
+					for (unsigned lane = 0; lane < kLanes; ++lane)
+					{
+						Add(partial.sum[k], partial.compensation[k], sum[k][lane]);
+						partial.compensation[k] += compensation[k][lane];
+					}
+				}
+			});
+
+			for (unsigned k = 0; k < N; ++k)
+			{
+				T sum = T(0), compensation = T(0);
+				for (const auto& partial : partials)
+				{
+					Add(sum, compensation, partial.sum[k]);
+					compensation += partial.compensation[k];
+				}
+				sums[k] = sum + compensation;
+			}
+		}
+	}
+
+	template <typename T>
+	Vec3<T> Sum (const std::vector<Vec3<T>>& points) {
+		T sums[3];
+		ReductionsDetail::Sums(points, [](const Vec3<T>& point, T* values) {
+			values[0] = point.x;
+			values[1] = point.y;
+			values[2] = point.z;
+		}, sums);
+		return Vec3<T>(sums[0], sums[1], sums[2]);
+	}
+
+	template <typename T>
+	Box3<T> Bounds (const std::vector<Vec3<T>>& points) {
+		using ReductionsDetail::kLanes;
+		ScratchVector<Box3<T>> partials(ParallelChunks(points.size(), ReductionsDetail::kGrainSize));
+		ParallelForChunks(points.size(), ReductionsDetail::kGrainSize, [&](const size_t chunk, const size_t first, const size_t last) {
+			if (first == last)
+			{
+				return;
+			}
+
+			// Every lane starts from the first point, so no lane is left empty
+			T minX[kLanes], minY[kLanes], minZ[kLanes], maxX[kLanes], maxY[kLanes], maxZ[kLanes];
+			std::fill(minX, minX + kLanes, points[first].x);
+			std::fill(minY, minY + kLanes, points[first].y);
+			std::fill(minZ, minZ + kLanes, points[first].z);
+			std::fill(maxX, maxX + kLanes, points[first].x);
+			std::fill(maxY, maxY + kLanes, points[first].y);
+			std::fill(maxZ, maxZ + kLanes, points[first].z);
+			size_t i = first;
+			for (; i + kLanes <= last; i += kLanes)
+			{
+				for (unsigned lane = 0; lane < kLanes; ++lane)
+				{
+					const auto& p = points[i + lane];
+					minX[lane] = p.x < minX[lane] ? p.x : minX[lane];
+					minY[lane] = p.y < minY[lane] ? p.y : minY[lane];
+					minZ[lane] = p.z < minZ[lane] ? p.z : minZ[lane];
+					maxX[lane] = p.x > maxX[lane] ? p.x : maxX[lane];
+					maxY[lane] = p.y > maxY[lane] ? p.y : maxY[lane];
+					maxZ[lane] = p.z > maxZ[lane] ? p.z : maxZ[lane];
+				}
+			}
+			auto& box = partials[chunk];
+			for (; i < last; ++i)
+			{
+				box.Merge(points[i]);
+			}
+			for (unsigned lane = 0; lane < kLanes; ++lane)
+			{
+				box.Merge(Box3<T>(Vec3<T>(minX[lane], minY[lane], minZ[lane]), Vec3<T>(maxX[lane], maxY[lane], maxZ[lane])));
+			}
+		});
+
+		Box3<T> bounds;
+		for (const auto& box : partials)
+		{
+			bounds.Merge(box);
+		}
+		return bounds;
+	}
+
+	template <typename T>
+	Vec3<T> Centroid (const std::vector<Vec3<T>>& points) {
+		if (points.empty())
+		{
+			throw std::invalid_argument("No points");
+		}
+		return Sum(points) / T(points.size());
+	}
+
+	template <typename T>
+	Mat3<T> Covariance (const std::vector<Vec3<T>>& points) {
+		return Covariance(points, Centroid(points));
+	}
+
+	template <typename T>
+	Mat3<T> Covariance (const std::vector<Vec3<T>>& points, const Vec3<T>& center) {
+		if (points.empty())
+		{
+			throw std::invalid_argument("No points");
+		}
+
+		T sums[6];
+		ReductionsDetail::Sums(points, [&center](const Vec3<T>& point, T* values) {
+			const T x = point.x - center.x, y = point.y - center.y, z = point.z - center.z;
+			values[0] = x * x;
+			values[1] = x * y;
+			values[2] = x * z;
+			values[3] = y * y;
+			values[4] = y * z;
+			values[5] = z * z;
+		}, sums);
+		const T n = T(points.size());
+		return Mat3<T>(
+			sums[0] / n, sums[1] / n, sums[2] / n,
+			sums[1] / n, sums[3] / n, sums[4] / n,
+			sums[2] / n, sums[4] / n, sums[5] / n);
+	}
+}
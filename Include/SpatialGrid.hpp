@@ -0,0 +1,559 @@
+﻿/**
+ * \file SpatialGrid.hpp
+ * \brief Hashed uniform grid for neighborhood queries on points
+ * \author Elekhyr
+ * \version 1.0
+ * \date 19/10/2026
+ * \copyright Copyright (c) 2017 Thomas Margier
+ *  This file is licensed under the MIT License, see https://opensource.org/licenses/MIT
+ */
+#pragma once
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <stdexcept>
+#include <vector>
+#include "Vec4.hpp" //todo : fix issue when including vec3 before vec4
+#include "Vec3.hpp"
+#include "MemoryResource.hpp"
+#include "Parallel.hpp"
+#include "SpatialSort.hpp"
+
+namespace Math
+{
+	/**
+	 * Points sorted by the cube of side cellSize containing them, for radius and nearest queries.
+	 * \details Cells are hashed into a table with as many entries as points, so memory does not depend on
+	 *	the extent of the points. Build computes the hash of every point and sorts the points by hash
+	 *	with RadixSort, then copies the points in cell order: the points of a cell
+	 *	are contiguous, and a query reads each neighboring cell as one range. The points of a hash entry
+	 *	shared by several cells are sorted by cell, and queries find their cell by binary search.
+	 *
+	 *	Rebuilding is meant to be cheap enough to run on every change of the points. Queries are
+	 *	fastest with a cell size close to the query radius. Points are referred to by their index
+	 *	in the vector given to Build.
+	 */
+	template <typename T>
+	class SpatialGrid
+	{
+	public:
+		static_assert(std::is_floating_point<T>::value, "T must be a floating point type");
+
+		explicit SpatialGrid(T cellSize); /// Empty grid, throws std::invalid_argument unless cellSize > 0
+		SpatialGrid(T cellSize, const std::vector<Vec3<T>>& points);
+
+		void Build(const std::vector<Vec3<T>>& points);
+
+		T CellSize() const;
+		size_t NbPoints() const;
+		const std::vector<Vec3<T>>& Points() const; /// Points in cell order
+		const std::vector<std::uint32_t>& Indices() const; /// Index of each of Points() in the built vector
+
+		template <typename Function>
+		void Radius(const Vec3<T>& center, T radius, Function function) const; /// Call function(index, squaredDistance) for each point within radius
+		void Radius(const Vec3<T>& center, T radius, std::vector<std::uint32_t>& indices) const; /// Append the points within radius
+
+		/**
+		 * Replace indices by the k points nearest to point, nearest first.
+		 * \details Visits rings of cells around point until no unvisited cell can hold a nearer point, reading
+		 *	every point instead once the rings would hold more cells than there are points. Equally distant
+		 *	points come by increasing index.
+		 */
+		void Nearest(const Vec3<T>& point, unsigned k, std::vector<std::uint32_t>& indices) const;
+
+		/**
+		 * Points within radius of each point, itself excluded, as one array.
+		 * \details The neighbors of point i are neighbors[offsets[i]] to neighbors[offsets[i + 1] - 1].
+		 *	Points are processed in cell order, spread over the hardware threads.
+		 */
+		void Neighbors(T radius, std::vector<size_t>& offsets, std::vector<std::uint32_t>& neighbors) const;
+
+	private:
+		static const size_t kGrainSize = 1 << 14;
+		static const size_t kNeighborsGrainSize = 1 << 10;
+
+		struct Cell
+		{
+			std::int64_t x;
+			std::int64_t y;
+			std::int64_t z;
+		};
+
+		Cell CellOf(const Vec3<T>& point) const;
+		std::uint32_t Hash(const Cell& cell) const;
+		static bool IsSameCell(const Cell& lhs, const Cell& rhs);
+		static bool IsLess(const Cell& lhs, const Cell& rhs);
+		std::uint32_t Bound(std::uint32_t first, std::uint32_t last, const Cell& cell, bool upper) const;
+		static double NbCells(const Cell& min, const Cell& max); /// Cells from min to max, 0 when empty
+
+		template <typename Function>
+		void VisitCell(const Cell& cell, Function function) const; /// Call function(position) for each point of cell
+		template <typename Function>
+		void VisitShell(const Cell& center, std::int64_t ring, const Cell& min, const Cell& max, Function function) const; /// Call function(position) for each point ring cells away from center, within min and max
+		template <typename Function>
+		void VisitRadius(const Vec3<T>& center, T radius, Function function) const; /// Call function(position, squaredDistance)
+
+		T mCellSize;
+		T mInverseCellSize;
+		std::uint32_t mMask;
+		Cell mMin; /// Bounds of the occupied cells
+		Cell mMax;
+		std::vector<Vec3<T>> mPoints;
+		std::vector<std::uint32_t> mIndices;
+		std::vector<std::uint32_t> mCellStart; /// Range of Points() of each hash entry
+		std::vector<std::uint32_t> mCellEnd;
+		std::vector<unsigned char> mShared; /// Hash entries holding points of several cells, sorted by cell
+	};
+
+	template <typename T>
+	SpatialGrid<T>::SpatialGrid(const T cellSize)
+		: mCellSize(cellSize), mInverseCellSize(1 / cellSize), mMask(0), mMin{ 0, 0, 0 }, mMax{ -1, -1, -1 } {
+		if (!(cellSize > 0))
+		{
+			throw std::invalid_argument("Cell size must be positive");
+		}
+	}
+
+	template <typename T>
+	SpatialGrid<T>::SpatialGrid(const T cellSize, const std::vector<Vec3<T>>& points)
+		: SpatialGrid(cellSize) {
+		Build(points);
+	}
+
+	template <typename T>
+	void SpatialGrid<T>::Build (const std::vector<Vec3<T>>& points) {
+		const size_t count = points.size();
+		if (count > 0xFFFFFFFF)
+		{
+			throw std::invalid_argument("Too many points for 32 bits indices");
+		}
+
+		unsigned bits = 0;
+		while ((size_t(1) << bits) < count)
+		{
+			++bits;
+		}
+		mMask = std::uint32_t((std::uint64_t(1) << bits) - 1);
+
+		// The sort is stable, so the input order is kept within a cell
+		ScratchVector<std::uint64_t> keys(count);
+		ScratchVector<std::uint32_t> indices(count);
+		ScratchVector<Cell> chunkBounds(2 * ParallelChunks(count, kGrainSize), Cell{ 0, 0, 0 });
+		ParallelForChunks(count, kGrainSize, [&](const size_t chunk, const size_t first, const size_t last) {
+			const auto lowest = std::numeric_limits<std::int64_t>::lowest();
+			const auto highest = std::numeric_limits<std::int64_t>::max();
+			Cell min{ highest, highest, highest };
+			Cell max{ lowest, lowest, lowest };
+			for (size_t i = first; i < last; ++i)
+			{
+				const auto cell = CellOf(points[i]);
+				keys[i] = Hash(cell);
+				indices[i] = std::uint32_t(i);
+				min = Cell{ std::min(min.x, cell.x), std::min(min.y, cell.y), std::min(min.z, cell.z) };
+				max = Cell{ std::max(max.x, cell.x), std::max(max.y, cell.y), std::max(max.z, cell.z) };
+			}
+			chunkBounds[2 * chunk] = min;
+			chunkBounds[2 * chunk + 1] = max;
+		});
+
+		mMin = Cell{ 0, 0, 0 };
+		mMax = Cell{ -1, -1, -1 };
+		for (size_t chunk = 0; count > 0 && chunk < chunkBounds.size() / 2; ++chunk)
+		{
+			const auto& min = chunkBounds[2 * chunk];
+			const auto& max = chunkBounds[2 * chunk + 1];
+			mMin = chunk == 0 ? min : Cell{ std::min(mMin.x, min.x), std::min(mMin.y, min.y), std::min(mMin.z, min.z) };
+			mMax = chunk == 0 ? max : Cell{ std::max(mMax.x, max.x), std::max(mMax.y, max.y), std::max(mMax.z, max.z) };
+		}
+
+		RadixSort(keys.data(), indices.data(), count, bits);
+
+		// Points in cell order, marking where the cell changes within a hash entry
+		mPoints.resize(count);
+		mIndices.resize(count);
+		mCellStart.assign(size_t(mMask) + 1, 0);
+		mCellEnd.assign(size_t(mMask) + 1, 0);
+		ScratchVector<unsigned char> changes(count);
+		ParallelFor(count, kGrainSize, [&](const size_t first, const size_t last) {
+			auto previous = first > 0 ? CellOf(points[indices[first - 1]]) : Cell{ 0, 0, 0 };
+			for (size_t i = first; i < last; ++i)
+			{
+				const auto index = indices[i];
+				const auto hash = std::uint32_t(keys[i]);
+				const auto cell = CellOf(points[index]);
+				mPoints[i] = points[index];
+				mIndices[i] = index;
+
+				const bool start = i == 0 || keys[i - 1] != hash;
+				if (start)
+				{
+					mCellStart[hash] = std::uint32_t(i);
+				}
+				if (i + 1 == count || keys[i + 1] != hash)
+				{
+					mCellEnd[hash] = std::uint32_t(i + 1);
+				}
+				changes[i] = !start && !IsSameCell(cell, previous);
+				previous = cell;
+			}
+		});
+
+		// Order shared entries by cell, so queries find the points of a cell by binary search
+		mShared.assign(size_t(mMask) + 1, 0);
+		ParallelFor(mShared.size(), kGrainSize, [&](const size_t first, const size_t last) {
+			ScratchVector<std::pair<Cell, std::uint32_t>> entry;
+			for (size_t hash = first; hash < last; ++hash)
+			{
+				const auto start = mCellStart[hash];
+				const auto end = mCellEnd[hash];
+				mShared[hash] = std::find(changes.begin() + start, changes.begin() + end, 1) != changes.begin() + end;
+				if (!mShared[hash])
+				{
+					continue;
+				}
+
+				entry.clear();
+				for (auto i = start; i < end; ++i)
+				{
+					entry.push_back(std::make_pair(CellOf(mPoints[i]), mIndices[i]));
+				}
+				std::sort(entry.begin(), entry.end(), [](const std::pair<Cell, std::uint32_t>& lhs, const std::pair<Cell, std::uint32_t>& rhs) {
+					return IsLess(lhs.first, rhs.first) || (IsSameCell(lhs.first, rhs.first) && lhs.second < rhs.second);
+				});
+				for (auto i = start; i < end; ++i)
+				{
+					mIndices[i] = entry[i - start].second;
+					mPoints[i] = points[mIndices[i]];
+				}
+			}
+		});
+	}
+
+	template <typename T>
+	T SpatialGrid<T>::CellSize () const {
+		return mCellSize;
+	}
+
+	template <typename T>
+	size_t SpatialGrid<T>::NbPoints () const {
+		return mPoints.size();
+	}
+
+	template <typename T>
+	const std::vector<Vec3<T>>& SpatialGrid<T>::Points () const {
+		return mPoints;
+	}
+
+	template <typename T>
+	const std::vector<std::uint32_t>& SpatialGrid<T>::Indices () const {
+		return mIndices;
+	}
+
+	template <typename T>
+	template <typename Function>
+	void SpatialGrid<T>::Radius (const Vec3<T>& center, const T radius, Function function) const {
+		VisitRadius(center, radius, [&](const std::uint32_t position, const T squaredDistance) {
+			function(mIndices[position], squaredDistance);
+		});
+	}
+
+	template <typename T>
+	void SpatialGrid<T>::Radius (const Vec3<T>& center, const T radius, std::vector<std::uint32_t>& indices) const {
+		VisitRadius(center, radius, [&](const std::uint32_t position, const T) {
+			indices.push_back(mIndices[position]);
+		});
+	}
+
+	template <typename T>
+	void SpatialGrid<T>::Nearest (const Vec3<T>& point, const unsigned k, std::vector<std::uint32_t>& indices) const {
+		indices.clear();
+		if (k == 0 || mPoints.empty())
+		{
+			return;
+		}
+
+		struct Candidate
+		{
+			T squaredDistance;
+			std::uint32_t index;
+
+			bool operator<(const Candidate& rhs) const
+			{
+				return squaredDistance < rhs.squaredDistance
+					|| (squaredDistance == rhs.squaredDistance && index < rhs.index);
+			}
+		};
+
+		// Max heap of the best k candidates
+		ScratchVector<Candidate> best;
+		const auto visit = [&](const std::uint32_t position) {
+			const auto delta = mPoints[position] - point;
+			const Candidate candidate{ Dot(delta, delta), mIndices[position] };
+			if (best.size() < k)
+			{
+				best.push_back(candidate);
+				std::push_heap(best.begin(), best.end());
+			}
+			else if (candidate < best.front())
+			{
+				std::pop_heap(best.begin(), best.end());
+				best.back() = candidate;
+				std::push_heap(best.begin(), best.end());
+			}
+		};
+
+		// Rings closer than the occupied cells are empty
+		const auto center = CellOf(point);
+		std::int64_t ring = 0;
+		ring = std::max(ring, std::max(mMin.x - center.x, center.x - mMax.x));
+		ring = std::max(ring, std::max(mMin.y - center.y, center.y - mMax.y));
+		ring = std::max(ring, std::max(mMin.z - center.z, center.z - mMax.z));
+
+		for (;; ++ring)
+		{
+			const Cell min{ std::max(center.x - ring, mMin.x), std::max(center.y - ring, mMin.y), std::max(center.z - ring, mMin.z) };
+			const Cell max{ std::min(center.x + ring, mMax.x), std::min(center.y + ring, mMax.y), std::min(center.z + ring, mMax.z) };
+
+			// Rings up to this one hold more cells than there are points: reading every point is cheaper
+			if (NbCells(min, max) > double(mPoints.size()))
+			{
+				best.clear();
+				for (std::uint32_t position = 0; position < mPoints.size(); ++position)
+				{
+					visit(position);
+				}
+				break;
+			}
+			VisitShell(center, ring, min, max, visit);
+
+			// Points left are in cells outside the ring, at least ring cells away from point
+			const T reach = T(ring) * mCellSize;
+			const bool covered = IsSameCell(min, mMin) && IsSameCell(max, mMax);
+			if (covered || (best.size() == k && best.front().squaredDistance <= reach * reach))
+			{
+				break;
+			}
+		}
+
+		std::sort_heap(best.begin(), best.end());
+		indices.reserve(best.size());
+		for (const auto& candidate : best)
+		{
+			indices.push_back(candidate.index);
+		}
+	}
+
+	template <typename T>
+	void SpatialGrid<T>::Neighbors (const T radius, std::vector<size_t>& offsets, std::vector<std::uint32_t>& neighbors) const {
+		const size_t count = mPoints.size();
+		ScratchVector<std::uint32_t> counts(count);
+		// Lists of the chunks take the scratch resource of the calling thread, shared with the workers
+		ScratchVector<ScratchVector<std::uint32_t>> chunkNeighbors(ParallelChunks(count, kNeighborsGrainSize));
+		ParallelForChunks(count, kNeighborsGrainSize, [&](const size_t chunk, const size_t first, const size_t last) {
+			auto& list = chunkNeighbors[chunk];
+			for (size_t i = first; i < last; ++i)
+			{
+				const size_t size = list.size();
+				VisitRadius(mPoints[i], radius, [&](const std::uint32_t position, const T) {
+					if (position != i)
+					{
+						list.push_back(mIndices[position]);
+					}
+				});
+				counts[i] = std::uint32_t(list.size() - size);
+			}
+		});
+
+		offsets.assign(count + 1, 0);
+		for (size_t i = 0; i < count; ++i)
+		{
+			offsets[mIndices[i] + 1] = counts[i];
+		}
+		for (size_t i = 0; i < count; ++i)
+		{
+			offsets[i + 1] += offsets[i];
+		}
+
+		neighbors.resize(offsets[count]);
+		ParallelForChunks(count, kNeighborsGrainSize, [&](const size_t chunk, const size_t first, const size_t last) {
+			auto source = chunkNeighbors[chunk].begin();
+			for (size_t i = first; i < last; ++i)
+			{
+				std::copy(source, source + counts[i], neighbors.begin() + offsets[mIndices[i]]);
+				source += counts[i];
+			}
+		});
+	}
+
+	template <typename T>
+	typename SpatialGrid<T>::Cell SpatialGrid<T>::CellOf (const Vec3<T>& point) const {
+		// Truncation corrected for negative values, cheaper than std::floor
+		const T x = point.x * mInverseCellSize, y = point.y * mInverseCellSize, z = point.z * mInverseCellSize;
+		const auto cellX = std::int64_t(x), cellY = std::int64_t(y), cellZ = std::int64_t(z);
+		return Cell{ cellX - (x < T(cellX)), cellY - (y < T(cellY)), cellZ - (z < T(cellZ)) };
+	}
+
+	template <typename T>
+	std::uint32_t SpatialGrid<T>::Hash (const Cell& cell) const {
+		const std::uint64_t hash = std::uint64_t(cell.x) * 73856093u ^ std::uint64_t(cell.y) * 19349663u ^ std::uint64_t(cell.z) * 83492791u;
+		return std::uint32_t(hash ^ hash >> 32) & mMask;
+	}
+
+	template <typename T>
+	bool SpatialGrid<T>::IsSameCell (const Cell& lhs, const Cell& rhs) {
+		return lhs.x == rhs.x && lhs.y == rhs.y && lhs.z == rhs.z;
+	}
+
+	template <typename T>
+	bool SpatialGrid<T>::IsLess (const Cell& lhs, const Cell& rhs) {
+		return lhs.x < rhs.x || (lhs.x == rhs.x && (lhs.y < rhs.y || (lhs.y == rhs.y && lhs.z < rhs.z)));
+	}
+
+	template <typename T>
+	std::uint32_t SpatialGrid<T>::Bound (std::uint32_t first, std::uint32_t last, const Cell& cell, const bool upper) const {
+		// First position of a range sorted by cell whose cell is not below cell (above cell when upper)
+		while (first < last)
+		{
+			const auto middle = first + (last - first) / 2;
+			const auto middleCell = CellOf(mPoints[middle]);
+			if (IsLess(middleCell, cell) || (upper && IsSameCell(middleCell, cell)))
+			{
+				first = middle + 1;
+			}
+			else
+			{
+				last = middle;
+			}
+		}
+		return first;
+	}
+
+	template <typename T>
+	template <typename Function>
+	void SpatialGrid<T>::VisitCell (const Cell& cell, Function function) const {
+		const auto hash = Hash(cell);
+		auto first = mCellStart[hash];
+		auto last = mCellEnd[hash];
+		if (mShared[hash])
+		{
+			first = Bound(first, last, cell, false);
+			last = Bound(first, last, cell, true);
+		}
+		else if (first == last || !IsSameCell(CellOf(mPoints[first]), cell))
+		{
+			return;
+		}
+
+		for (auto position = first; position < last; ++position)
+		{
+			function(position);
+		}
+	}
+
+	template <typename T>
+	double SpatialGrid<T>::NbCells (const Cell& min, const Cell& max) {
+		// In double: the box of sparse points can hold more than 2^64 cells
+		const auto side = [](const std::int64_t low, const std::int64_t high) {
+			return high < low ? 0.0 : double(high) - double(low) + 1;
+		};
+		return side(min.x, max.x) * side(min.y, max.y) * side(min.z, max.z);
+	}
+
+	template <typename T>
+	template <typename Function>
+	void SpatialGrid<T>::VisitShell (const Cell& center, const std::int64_t ring, const Cell& min, const Cell& max, Function function) const {
+		if (ring == 0)
+		{
+			if (NbCells(min, max) > 0)
+			{
+				VisitCell(center, function);
+			}
+			return;
+		}
+
+		// The two x faces, then the y faces without their x edges, then the z faces without their x and y edges
+		const std::int64_t facesX[2] = { center.x - ring, center.x + ring };
+		const std::int64_t facesY[2] = { center.y - ring, center.y + ring };
+		const std::int64_t facesZ[2] = { center.z - ring, center.z + ring };
+		const auto innerMinX = std::max(center.x - ring + 1, min.x), innerMaxX = std::min(center.x + ring - 1, max.x);
+		const auto innerMinY = std::max(center.y - ring + 1, min.y), innerMaxY = std::min(center.y + ring - 1, max.y);
+		for (const auto x : facesX)
+		{
+			for (auto y = min.y; x >= min.x && x <= max.x && y <= max.y; ++y)
+			{
+				for (auto z = min.z; z <= max.z; ++z)
+				{
+					VisitCell(Cell{ x, y, z }, function);
+				}
+			}
+		}
+		for (const auto y : facesY)
+		{
+			for (auto x = innerMinX; y >= min.y && y <= max.y && x <= innerMaxX; ++x)
+			{
+				for (auto z = min.z; z <= max.z; ++z)
+				{
+					VisitCell(Cell{ x, y, z }, function);
+				}
+			}
+		}
+		for (const auto z : facesZ)
+		{
+			for (auto x = innerMinX; z >= min.z && z <= max.z && x <= innerMaxX; ++x)
+			{
+				for (auto y = innerMinY; y <= innerMaxY; ++y)
+				{
+					VisitCell(Cell{ x, y, z }, function);
+				}
+			}
+		}
+	}
+
+	template <typename T>
+	template <typename Function>
+	void SpatialGrid<T>::VisitRadius (const Vec3<T>& center, const T radius, Function function) const {
+		if (mPoints.empty() || !(radius >= 0))
+		{
+			return;
+		}
+
+		const auto low = CellOf(Vec3<T>(center.x - radius, center.y - radius, center.z - radius));
+		const auto high = CellOf(Vec3<T>(center.x + radius, center.y + radius, center.z + radius));
+		const Cell min{ std::max(low.x, mMin.x), std::max(low.y, mMin.y), std::max(low.z, mMin.z) };
+		const Cell max{ std::min(high.x, mMax.x), std::min(high.y, mMax.y), std::min(high.z, mMax.z) };
+		const T squaredRadius = radius * radius;
+		const auto test = [&](const std::uint32_t position) {
+			const auto delta = mPoints[position] - center;
+			const T squaredDistance = Dot(delta, delta);
+			if (squaredDistance <= squaredRadius)
+			{
+				function(position, squaredDistance);
+			}
+		};
+
+		// More cells than points: reading every point is cheaper
+		if (NbCells(min, max) > double(mPoints.size()))
+		{
+			for (std::uint32_t position = 0; position < mPoints.size(); ++position)
+			{
+				test(position);
+			}
+			return;
+		}
+
+		for (auto x = min.x; x <= max.x; ++x)
+		{
+			for (auto y = min.y; y <= max.y; ++y)
+			{
+				for (auto z = min.z; z <= max.z; ++z)
+				{
+					VisitCell(Cell{ x, y, z }, test);
+				}
+			}
+		}
+	}
+
+	typedef SpatialGrid<float> SpatialGridf;
+	typedef SpatialGrid<double> SpatialGridd;
+}
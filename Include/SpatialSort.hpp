@@ -0,0 +1,192 @@
+﻿/**
+ * \file SpatialSort.hpp
+ * \brief Morton and Hilbert codes, and spatial sorting of point arrays
+ * \author Elekhyr
+ * \version 1.0
+ * \date 19/10/2026
+ * \copyright Copyright (c) 2017 Thomas Margier
+ *  This file is licensed under the MIT License, see https://opensource.org/licenses/MIT
+ */
+#pragma once
+#include <algorithm>
+#include <cstdint>
+#include <stdexcept>
+#include <vector>
+#include "Vec4.hpp" //todo : fix issue when including vec3 before vec4
+#include "Vec3.hpp"
+#include "Vec2.hpp"
+#include "MemoryResource.hpp"
+#include "Parallel.hpp"
+
+namespace Math
+{
+	/**
+	 * Position of a cell along a space filling curve, from its integer coordinates.
+	 * \details Morton codes interleave the bits of the coordinates, x holding the highest bit of each
+	 *	level. They use the BMI2 pdep instruction when the compiler targets it. Hilbert codes follow a
+	 *	curve of 2^order cells per side whose consecutive cells are always adjacent, which keeps
+	 *	nearby points closer in the order than Morton codes. Coordinates must be below 2^order.
+	 */
+	std::uint64_t Morton2D(std::uint32_t x, std::uint32_t y); /// 32 bits coordinates
+	std::uint64_t Morton3D(std::uint32_t x, std::uint32_t y, std::uint32_t z); /// 21 bits coordinates
+	std::uint64_t Hilbert2D(std::uint32_t x, std::uint32_t y, unsigned order = 32); /// order at most 32
+	std::uint64_t Hilbert3D(std::uint32_t x, std::uint32_t y, std::uint32_t z, unsigned order = 21); /// order at most 21
+
+	/**
+	 * Stable sort of keys by their lowest bits, values following their key.
+	 * \details Least significant digit radix sort, 11 bits per pass. Each pass counts the digits of
+	 *	contiguous chunks of keys over the hardware threads, then each chunk scatters its keys. values may be null.
+	 */
+	void RadixSort(std::uint64_t* keys, std::uint32_t* values, size_t count, unsigned bits);
+
+	enum SpaceFillingCurve
+	{
+		kMorton,
+		kHilbert
+	};
+
+	/**
+	 * Replace order by the indices of the points along a space filling curve.
+	 * \details Points are quantized over the square or cube bounding them, 16 bits per coordinate in 2D
+	 *	and 10 in 3D. Points in the same cell keep their order. Codes are computed and sorted over the
+	 *	hardware threads.
+	 */
+	template <typename T>
+	void SpatialOrder(const std::vector<Vec2<T>>& points, SpaceFillingCurve curve, std::vector<std::uint32_t>& order);
+	template <typename T>
+	void SpatialOrder(const std::vector<Vec3<T>>& points, SpaceFillingCurve curve, std::vector<std::uint32_t>& order);
+
+	/**
+	 * Reorder values, values[order[i]] moving to position i.
+	 * \details Points and the attributes carried with them are sorted with the same order.
+	 */
+	template <typename U, typename Allocator>
+	void Permute(std::vector<U, Allocator>& values, const std::vector<std::uint32_t>& order);
+
+	/**
+	 * Reorder points along a space filling curve, order receiving their former indices.
+	 */
+	template <typename T>
+	void SpatialSort(std::vector<Vec2<T>>& points, SpaceFillingCurve curve, std::vector<std::uint32_t>& order);
+	template <typename T>
+	void SpatialSort(std::vector<Vec3<T>>& points, SpaceFillingCurve curve, std::vector<std::uint32_t>& order);
+
+	namespace SpatialSortDetail
+	{
+		const size_t kGrainSize = 1 << 14;
+
+		/**
+		 * Sort indices by codes, computed by code(point, min, max) over the hardware threads.
+		 */
+		template <typename Point, typename Bounds, typename Code>
+		void Order(const std::vector<Point>& points, Bounds bounds, Code code, std::vector<std::uint32_t>& order, unsigned bits)
+		{
+			const size_t count = points.size();
+			if (count >= 0xFFFFFFFF)
+			{
+				throw std::invalid_argument("Too many points for 32 bits indices");
+			}
+			order.resize(count);
+			if (count == 0)
+			{
+				return;
+			}
+
+			// Bounds of each chunk, then of all points
+			ScratchVector<Point> chunkBounds(2 * ParallelChunks(count, kGrainSize));
+			ParallelForChunks(count, kGrainSize, [&](const size_t chunk, const size_t first, const size_t last) {
+				Point min = points[first], max = points[first];
+				for (size_t i = first; i < last; ++i)
+				{
+					bounds(points[i], min, max);
+				}
+				chunkBounds[2 * chunk] = min;
+				chunkBounds[2 * chunk + 1] = max;
+			});
+			Point min = chunkBounds[0], max = chunkBounds[1];
+			for (size_t chunk = 1; chunk < chunkBounds.size() / 2; ++chunk)
+			{
+				bounds(chunkBounds[2 * chunk], min, max);
+				bounds(chunkBounds[2 * chunk + 1], min, max);
+			}
+
+			ScratchVector<std::uint64_t> keys(count);
+			ParallelFor(count, kGrainSize, [&](const size_t first, const size_t last) {
+				for (size_t i = first; i < last; ++i)
+				{
+					keys[i] = code(points[i], min, max);
+					order[i] = std::uint32_t(i);
+				}
+			});
+			RadixSort(keys.data(), order.data(), count, bits);
+		}
+
+		template <typename T>
+		std::uint32_t Quantize(const T value, const T min, const T scale, const std::uint32_t last)
+		{
+			return std::uint32_t(std::min(T(last), std::max(T(0), (value - min) * scale)));
+		}
+	}
+
+	template <typename T>
+	void SpatialOrder (const std::vector<Vec2<T>>& points, const SpaceFillingCurve curve, std::vector<std::uint32_t>& order) {
+		const unsigned kBits = 16;
+		const std::uint32_t last = (std::uint32_t(1) << kBits) - 1;
+		SpatialSortDetail::Order(points, [](const Vec2<T>& point, Vec2<T>& min, Vec2<T>& max) {
+			min = Vec2<T>(std::min(min.x, point.x), std::min(min.y, point.y));
+			max = Vec2<T>(std::max(max.x, point.x), std::max(max.y, point.y));
+		}, [curve, last](const Vec2<T>& point, const Vec2<T>& min, const Vec2<T>& max) {
+			const T size = std::max(max.x - min.x, max.y - min.y);
+			const T scale = size > 0 ? T(last) / size : T(0);
+			const auto x = SpatialSortDetail::Quantize(point.x, min.x, scale, last);
+			const auto y = SpatialSortDetail::Quantize(point.y, min.y, scale, last);
+			return curve == kHilbert ? Hilbert2D(x, y, kBits) : Morton2D(x, y);
+		}, order, 2 * kBits);
+	}
+
+	template <typename T>
+	void SpatialOrder (const std::vector<Vec3<T>>& points, const SpaceFillingCurve curve, std::vector<std::uint32_t>& order) {
+		const unsigned kBits = 10;
+		const std::uint32_t last = (std::uint32_t(1) << kBits) - 1;
+		SpatialSortDetail::Order(points, [](const Vec3<T>& point, Vec3<T>& min, Vec3<T>& max) {
+			min = Vec3<T>(std::min(min.x, point.x), std::min(min.y, point.y), std::min(min.z, point.z));
+			max = Vec3<T>(std::max(max.x, point.x), std::max(max.y, point.y), std::max(max.z, point.z));
+		}, [curve, last](const Vec3<T>& point, const Vec3<T>& min, const Vec3<T>& max) {
+			const T size = std::max(max.x - min.x, std::max(max.y - min.y, max.z - min.z));
+			const T scale = size > 0 ? T(last) / size : T(0);
+			const auto x = SpatialSortDetail::Quantize(point.x, min.x, scale, last);
+			const auto y = SpatialSortDetail::Quantize(point.y, min.y, scale, last);
+			const auto z = SpatialSortDetail::Quantize(point.z, min.z, scale, last);
+			return curve == kHilbert ? Hilbert3D(x, y, z, kBits) : Morton3D(x, y, z);
+		}, order, 3 * kBits);
+	}
+
+	template <typename U, typename Allocator>
+	void Permute (std::vector<U, Allocator>& values, const std::vector<std::uint32_t>& order) {
+		if (values.size() != order.size())
+		{
+			throw std::invalid_argument("Values and order must have the same size");
+		}
+
+		std::vector<U, Allocator> permuted(values.size(), values.get_allocator());
+		ParallelFor(order.size(), SpatialSortDetail::kGrainSize, [&](const size_t first, const size_t last) {
+			for (size_t i = first; i < last; ++i)
+			{
+				permuted[i] = values[order[i]];
+			}
+		});
+		values.swap(permuted);
+	}
+
+	template <typename T>
+	void SpatialSort (std::vector<Vec2<T>>& points, const SpaceFillingCurve curve, std::vector<std::uint32_t>& order) {
+		SpatialOrder(points, curve, order);
+		Permute(points, order);
+	}
+
+	template <typename T>
+	void SpatialSort (std::vector<Vec3<T>>& points, const SpaceFillingCurve curve, std::vector<std::uint32_t>& order) {
+		SpatialOrder(points, curve, order);
+		Permute(points, order);
+	}
+}
@@ -0,0 +1,480 @@
+﻿/**
+ * \file Sphere.hpp
+ * \brief Bounding sphere
+ * \author Elekhyr
+ * \version 1.0
+ * \date 19/10/2026
+ * \copyright Copyright (c) 2017 Thomas Margier
+ *  This file is licensed under the MIT License, see https://opensource.org/licenses/MIT
+ */
+#pragma once
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <vector>
+#include "Vec4.hpp" //todo : fix issue when including vec3 before vec4
+#include "Vec3.hpp"
+#include "Box3.hpp"
+#include "MemoryResource.hpp"
+#include "Parallel.hpp"
+
+namespace Math
+{
+	/**
+	 * Sphere given by its center and radius, surface included.
+	 * \details The default sphere is empty (negative radius), so merging points into it gives a sphere holding them.
+	 */
+	template <typename T>
+	struct Sphere
+	{
+		static_assert(std::is_floating_point<T>::value, "T must be a floating point type");
+
+		// Constructors
+		Sphere(); /// Empty sphere
+		Sphere(const Vec3<T>& center, T radius);
+
+		/**
+		 * Sphere holding every point, in linear time.
+		 * \details EPOS-14: the farthest pair among the extreme points along 7 directions gives a first
+		 *	sphere, then a Ritter pass grows it over the points outside. In parallel mode every chunk
+		 *	grows its own copy and the results are merged, which can give a slightly larger sphere.
+		 */
+		static Sphere FromPoints(const std::vector<Vec3<T>>& points, bool parallel = false);
+
+		// Functions
+		bool IsEmpty() const;
+
+		void Merge(const Vec3<T>& point); /// Smallest sphere holding this one and point
+		void Merge(const Sphere& sphere); /// Smallest sphere holding both
+
+		bool Contains(const Vec3<T>& point) const;
+		bool Overlaps(const Sphere& sphere) const;
+		bool Overlaps(const Box3<T>& box) const;
+
+		/**
+		 * Intersection with the ray origin + t * direction, direction need not be normalized.
+		 * \details Clips [tMin, tMax] to the part of the ray inside the sphere, false when nothing is left.
+		 */
+		bool IntersectRay(const Vec3<T>& origin, const Vec3<T>& direction, T& tMin, T& tMax) const;
+
+		// Attributes
+		Vec3<T> center;
+		T radius;
+
+	private:
+		static const size_t kGrainSize = 1 << 14;
+		static const unsigned kDirections = 7;
+
+		static T Project(const Vec3<T>& point, unsigned direction);
+		static T SquaredDistance(const Vec3<T>& a, const Vec3<T>& b);
+		static T Enclosing(T radius, T first, T second);
+	};
+
+	/**
+	 * Spheres stored as one array per component, with tests of one query against all of them.
+	 * \details The loops have no branch and are split over the hardware threads on large arrays.
+	 *	result[i] is 1 when sphere i passes the test.
+	 */
+	template <typename T>
+	class SphereArray
+	{
+	public:
+		SphereArray();
+		explicit SphereArray(const std::vector<Sphere<T>>& spheres);
+
+		size_t Size() const;
+		void Clear();
+		void Push(const Sphere<T>& sphere);
+		Sphere<T> Get(size_t i) const;
+		void Set(size_t i, const Sphere<T>& sphere);
+
+		const std::vector<T>& X() const; /// Center components
+		const std::vector<T>& Y() const;
+		const std::vector<T>& Z() const;
+		const std::vector<T>& Radius() const;
+
+		void Contains(const Vec3<T>& point, std::vector<unsigned char>& result) const;
+		void Overlaps(const Sphere<T>& sphere, std::vector<unsigned char>& result) const;
+		void IntersectRay(const Vec3<T>& origin, const Vec3<T>& direction, T tMin, T tMax, std::vector<unsigned char>& result) const;
+
+	private:
+		static const size_t kGrainSize = 1 << 14;
+
+		std::vector<T> mX;
+		std::vector<T> mY;
+		std::vector<T> mZ;
+		std::vector<T> mRadius;
+	};
+
+	template <typename T>
+	Sphere<T>::Sphere()
+		: center(0, 0, 0), radius(-1) {
+	}
+
+	template <typename T>
+	Sphere<T>::Sphere(const Vec3<T>& center, const T radius)
+		: center(center), radius(radius) {
+	}
+
+	template <typename T>
+	Sphere<T> Sphere<T>::FromPoints (const std::vector<Vec3<T>>& points, const bool parallel) {
+		if (points.empty())
+		{
+			return Sphere();
+		}
+
+		// Lowest and highest point along each direction, one set per chunk
+		const size_t grainSize = parallel ? kGrainSize : points.size();
+		const auto chunks = ParallelChunks(points.size(), grainSize);
+		ScratchVector<size_t> extremes(chunks * 2 * kDirections, 0);
+		ParallelForChunks(points.size(), grainSize, [&](const size_t chunk, const size_t first, const size_t last) {
+			size_t* local = &extremes[chunk * 2 * kDirections];
+			T lowest[kDirections], highest[kDirections];
+			for (unsigned d = 0; d < kDirections; ++d)
+			{
+				local[2 * d] = local[2 * d + 1] = first;
+				lowest[d] = highest[d] = Project(points[first], d);
+			}
+			for (size_t i = first + 1; i < last; ++i)
+			{
+				for (unsigned d = 0; d < kDirections; ++d)
+				{
+					const T projection = Project(points[i], d);
+					if (projection < lowest[d])
+					{
+						lowest[d] = projection;
+						local[2 * d] = i;
+					}
+					if (projection > highest[d])
+					{
+						highest[d] = projection;
+						local[2 * d + 1] = i;
+					}
+				}
+			}
+		});
+
+		size_t lowest[kDirections], highest[kDirections];
+		for (unsigned d = 0; d < kDirections; ++d)
+		{
+			lowest[d] = extremes[2 * d];
+			highest[d] = extremes[2 * d + 1];
+			for (size_t chunk = 1; chunk < chunks; ++chunk)
+			{
+				const size_t* local = &extremes[chunk * 2 * kDirections];
+				if (Project(points[local[2 * d]], d) < Project(points[lowest[d]], d))
+				{
+					lowest[d] = local[2 * d];
+				}
+				if (Project(points[local[2 * d + 1]], d) > Project(points[highest[d]], d))
+				{
+					highest[d] = local[2 * d + 1];
+				}
+			}
+		}
+
+		// First sphere on the most distant pair of extremes
+		unsigned widest = 0;
+		T widestDistance = -1;
+		for (unsigned d = 0; d < kDirections; ++d)
+		{
+			const T distance = SquaredDistance(points[lowest[d]], points[highest[d]]);
+			if (distance > widestDistance)
+			{
+				widest = d;
+				widestDistance = distance;
+			}
+		}
+		const auto& a = points[lowest[widest]];
+		const auto& b = points[highest[widest]];
+		const Sphere initial(Vec3<T>((a.x + b.x) / 2, (a.y + b.y) / 2, (a.z + b.z) / 2), std::sqrt(widestDistance) / 2);
+
+		// Ritter pass, the chunk spheres being merged afterwards
+		ScratchVector<Sphere> spheres(chunks, initial);
+		ParallelForChunks(points.size(), grainSize, [&](const size_t chunk, const size_t first, const size_t last) {
+			Sphere sphere = initial;
+			for (size_t i = first; i < last; ++i)
+			{
+				sphere.Merge(points[i]);
+			}
+			spheres[chunk] = sphere;
+		});
+
+		Sphere sphere = spheres[0];
+		for (size_t chunk = 1; chunk < chunks; ++chunk)
+		{
+			sphere.Merge(spheres[chunk]);
+		}
+		return sphere;
+	}
+
+	template <typename T>
+	bool Sphere<T>::IsEmpty () const {
+		return radius < 0;
+	}
+
+	template <typename T>
+	void Sphere<T>::Merge (const Vec3<T>& point) {
+		if (IsEmpty())
+		{
+			center = point;
+			radius = 0;
+			return;
+		}
+
+		const T distance2 = SquaredDistance(center, point);
+		if (distance2 <= radius * radius)
+		{
+			return;
+		}
+
+		// Move the center toward point so that the opposite side of the sphere stays put
+		const T distance = std::sqrt(distance2);
+		const T newRadius = (radius + distance) / 2;
+		const T shift = (newRadius - radius) / distance;
+		const Vec3<T> previous = center;
+		center.x += (point.x - center.x) * shift;
+		center.y += (point.y - center.y) * shift;
+		center.z += (point.z - center.z) * shift;
+		radius = Enclosing(newRadius, std::sqrt(SquaredDistance(center, point)),
+			std::sqrt(SquaredDistance(center, previous)) + radius);
+	}
+
+	template <typename T>
+	void Sphere<T>::Merge (const Sphere& sphere) {
+		if (sphere.IsEmpty())
+		{
+			return;
+		}
+		if (IsEmpty())
+		{
+			*this = sphere;
+			return;
+		}
+
+		const T distance = std::sqrt(SquaredDistance(center, sphere.center));
+		if (distance + sphere.radius <= radius)
+		{
+			return;
+		}
+		if (distance + radius <= sphere.radius)
+		{
+			*this = sphere;
+			return;
+		}
+
+		const T newRadius = (distance + radius + sphere.radius) / 2;
+		const T shift = (newRadius - radius) / distance;
+		const Vec3<T> previous = center;
+		center.x += (sphere.center.x - center.x) * shift;
+		center.y += (sphere.center.y - center.y) * shift;
+		center.z += (sphere.center.z - center.z) * shift;
+		radius = Enclosing(newRadius, std::sqrt(SquaredDistance(center, sphere.center)) + sphere.radius,
+			std::sqrt(SquaredDistance(center, previous)) + radius);
+	}
+
+	template <typename T>
+	bool Sphere<T>::Contains (const Vec3<T>& point) const {
+		return SquaredDistance(center, point) <= radius * radius && !IsEmpty();
+	}
+
+	template <typename T>
+	bool Sphere<T>::Overlaps (const Sphere& sphere) const {
+		const T radii = radius + sphere.radius;
+		return SquaredDistance(center, sphere.center) <= radii * radii && !IsEmpty() && !sphere.IsEmpty();
+	}
+
+	template <typename T>
+	bool Sphere<T>::Overlaps (const Box3<T>& box) const {
+		const T dx = std::max(std::max(box.min.x - center.x, center.x - box.max.x), T(0));
+		const T dy = std::max(std::max(box.min.y - center.y, center.y - box.max.y), T(0));
+		const T dz = std::max(std::max(box.min.z - center.z, center.z - box.max.z), T(0));
+		return dx * dx + dy * dy + dz * dz <= radius * radius && !IsEmpty() && !box.IsEmpty();
+	}
+
+	template <typename T>
+	bool Sphere<T>::IntersectRay (const Vec3<T>& origin, const Vec3<T>& direction, T& tMin, T& tMax) const {
+		// Roots of |origin + t * direction - center|^2 = radius^2
+		const Vec3<T> offset(origin.x - center.x, origin.y - center.y, origin.z - center.z);
+		const T a = direction.x * direction.x + direction.y * direction.y + direction.z * direction.z;
+		const T b = offset.x * direction.x + offset.y * direction.y + offset.z * direction.z;
+		const T c = offset.x * offset.x + offset.y * offset.y + offset.z * offset.z - radius * radius;
+		const T discriminant = b * b - a * c;
+		if (IsEmpty() || discriminant < 0 || a == 0)
+		{
+			return false;
+		}
+
+		const T root = std::sqrt(discriminant);
+		tMin = std::max(tMin, (-b - root) / a);
+		tMax = std::min(tMax, (-b + root) / a);
+		return tMin <= tMax;
+	}
+
+	template <typename T>
+	T Sphere<T>::Project (const Vec3<T>& point, const unsigned direction) {
+		// The 3 axes and the 4 diagonals of the cube, left unnormalized
+		switch (direction)
+		{
+		case 0: return point.x;
+		case 1: return point.y;
+		case 2: return point.z;
+		case 3: return point.x + point.y + point.z;
+		case 4: return point.x + point.y - point.z;
+		case 5: return point.x - point.y + point.z;
+		default: return point.x - point.y - point.z;
+		}
+	}
+
+	template <typename T>
+	T Sphere<T>::Enclosing (const T radius, const T first, const T second) {
+		// The rounded center may sit a few ulps off, a few ulps more keep inside what was inside
+		return std::max(radius, std::max(first, second)) * (1 + 4 * std::numeric_limits<T>::epsilon());
+	}
+
+	template <typename T>
+	T Sphere<T>::SquaredDistance (const Vec3<T>& a, const Vec3<T>& b) {
+		const T dx = a.x - b.x;
+		const T dy = a.y - b.y;
+		const T dz = a.z - b.z;
+		return dx * dx + dy * dy + dz * dz;
+	}
+
+	template <typename T>
+	SphereArray<T>::SphereArray() {
+	}
+
+	template <typename T>
+	SphereArray<T>::SphereArray(const std::vector<Sphere<T>>& spheres) {
+		mX.reserve(spheres.size());
+		mY.reserve(spheres.size());
+		mZ.reserve(spheres.size());
+		mRadius.reserve(spheres.size());
+		for (const auto& sphere : spheres)
+		{
+			Push(sphere);
+		}
+	}
+
+	template <typename T>
+	size_t SphereArray<T>::Size () const {
+		return mX.size();
+	}
+
+	template <typename T>
+	void SphereArray<T>::Clear () {
+		mX.clear();
+		mY.clear();
+		mZ.clear();
+		mRadius.clear();
+	}
+
+	template <typename T>
+	void SphereArray<T>::Push (const Sphere<T>& sphere) {
+		mX.push_back(sphere.center.x);
+		mY.push_back(sphere.center.y);
+		mZ.push_back(sphere.center.z);
+		mRadius.push_back(sphere.radius);
+	}
+
+	template <typename T>
+	Sphere<T> SphereArray<T>::Get (const size_t i) const {
+		return Sphere<T>(Vec3<T>(mX[i], mY[i], mZ[i]), mRadius[i]);
+	}
+
+	template <typename T>
+	void SphereArray<T>::Set (const size_t i, const Sphere<T>& sphere) {
+		mX[i] = sphere.center.x;
+		mY[i] = sphere.center.y;
+		mZ[i] = sphere.center.z;
+		mRadius[i] = sphere.radius;
+	}
+
+	template <typename T>
+	const std::vector<T>& SphereArray<T>::X () const {
+		return mX;
+	}
+
+	template <typename T>
+	const std::vector<T>& SphereArray<T>::Y () const {
+		return mY;
+	}
+
+	template <typename T>
+	const std::vector<T>& SphereArray<T>::Z () const {
+		return mZ;
+	}
+
+	template <typename T>
+	const std::vector<T>& SphereArray<T>::Radius () const {
+		return mRadius;
+	}
+
+	template <typename T>
+	void SphereArray<T>::Contains (const Vec3<T>& point, std::vector<unsigned char>& result) const {
+		result.resize(Size());
+		ParallelFor(Size(), kGrainSize, [&](const size_t first, const size_t last) {
+			const T px = point.x, py = point.y, pz = point.z;
+			const T* x = mX.data();
+			const T* y = mY.data();
+			const T* z = mZ.data();
+			const T* r = mRadius.data();
+			unsigned char* out = result.data();
+			for (size_t i = first; i < last; ++i)
+			{
+				const T dx = x[i] - px, dy = y[i] - py, dz = z[i] - pz;
+				out[i] = (dx * dx + dy * dy + dz * dz <= r[i] * r[i]) & (r[i] >= 0);
+			}
+		});
+	}
+
+	template <typename T>
+	void SphereArray<T>::Overlaps (const Sphere<T>& sphere, std::vector<unsigned char>& result) const {
+		result.resize(Size());
+		ParallelFor(Size(), kGrainSize, [&](const size_t first, const size_t last) {
+			const T cx = sphere.center.x, cy = sphere.center.y, cz = sphere.center.z, radius = sphere.radius;
+			const T* x = mX.data();
+			const T* y = mY.data();
+			const T* z = mZ.data();
+			const T* r = mRadius.data();
+			unsigned char* out = result.data();
+			for (size_t i = first; i < last; ++i)
+			{
+				const T dx = x[i] - cx, dy = y[i] - cy, dz = z[i] - cz;
+				const T radii = r[i] + radius;
+				out[i] = (dx * dx + dy * dy + dz * dz <= radii * radii) & (r[i] >= 0) & (radius >= 0);
+			}
+		});
+	}
+
+	template <typename T>
+	void SphereArray<T>::IntersectRay (const Vec3<T>& origin, const Vec3<T>& direction, const T tMin, const T tMax,
+		std::vector<unsigned char>& result) const {
+		result.resize(Size());
+		ParallelFor(Size(), kGrainSize, [&](const size_t first, const size_t last) {
+			const T ox = origin.x, oy = origin.y, oz = origin.z;
+			const T ux = direction.x, uy = direction.y, uz = direction.z;
+			const T a = ux * ux + uy * uy + uz * uz;
+			const T* x = mX.data();
+			const T* y = mY.data();
+			const T* z = mZ.data();
+			const T* r = mRadius.data();
+			unsigned char* out = result.data();
+			for (size_t i = first; i < last; ++i)
+			{
+				// Same roots as Sphere::IntersectRay, compared to [tMin, tMax] scaled by a to avoid the division
+				const T dx = ox - x[i], dy = oy - y[i], dz = oz - z[i];
+				const T b = dx * ux + dy * uy + dz * uz;
+				const T c = dx * dx + dy * dy + dz * dz - r[i] * r[i];
+				const T discriminant = b * b - a * c;
+				const T root = std::sqrt(discriminant > 0 ? discriminant : T(0));
+				out[i] = (discriminant >= 0) & (-b + root >= tMin * a) & (-b - root <= tMax * a) & (r[i] >= 0) & (a > 0);
+			}
+		});
+	}
+
+	typedef Sphere<float> Spheref;
+	typedef Sphere<double> Sphered;
+	typedef SphereArray<float> SphereArrayf;
+	typedef SphereArray<double> SphereArrayd;
+}
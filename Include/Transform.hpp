@@ -1,6 +1,6 @@
 ﻿/**
  * \file Transform.hpp
- * \brief todo
+ * \brief Transformation, view and projection matrices
  * \author Elekhyr
  * \version 1.0
  * \date 19/09/2017
@@ -9,11 +9,24 @@
  */
 #pragma once
 #include "Mat4.hpp"
+#include "Parallel.hpp"
 #include <stdexcept>
 #include <cmath>
+#include <vector>
 
 namespace Math
 {
+	/**
+	 * Window rectangle and depth range that normalized device coordinates map to.
+	 * \details x and y go from [-1, 1] to [x, x + width] and [y, y + height], z from [-1, 1] to [minDepth, maxDepth].
+	 */
+	template <typename T>
+	struct Viewport
+	{
+		T x, y, width, height;
+		T minDepth, maxDepth;
+	};
+
 	template<typename T>
 	class Transform
 	{
@@ -41,6 +54,37 @@ namespace Math
 		static Mat4<T>& ScaleX(const Mat4<T>& mat4, const T& x);
 		static Mat4<T>& ScaleY(const Mat4<T>& mat4, const T& y);
 		static Mat4<T>& ScaleZ(const Mat4<T>& mat4, const T& z);
+
+		/**
+		 * OpenGL projections, from a right handed view space looking down -z to clip space.
+		 * \details Visible points end with x, y and z in [-w, w], the near plane mapping to -w and the far plane to w.
+		 *	fovY is the vertical field of view in radians. Throws std::invalid_argument for an empty
+		 *	volume, a non positive near distance or aspect, or a field of view outside (0, pi).
+		 */
+		static Mat4<T> Perspective(T fovY, T aspect, T zNear, T zFar);
+		static Mat4<T> Orthographic(T left, T right, T bottom, T top, T zNear, T zFar);
+
+		/**
+		 * View matrix of an eye at eye looking at target, up giving the vertical.
+		 * \details Throws std::invalid_argument when eye and target are the same or up is along the view direction.
+		 */
+		static Mat4<T> LookAt(const Vec3<T>& eye, const Vec3<T>& target, const Vec3<T>& up);
+
+		/**
+		 * Transform points by matrix, divide by w and map to viewport, in one pass over the hardware threads.
+		 * \details projected[i] gets the normalized device coordinates of points[i], or its window
+		 *	coordinates when a viewport is given, and 1 / w in w for perspective correct interpolation.
+		 *	That w is not positive for points behind the eye, whose coordinates are meaningless.
+		 */
+		static void Project(const Mat4<T>& matrix, const std::vector<Vec3<T>>& points, std::vector<Vec4<T>>& projected);
+		static void Project(const Mat4<T>& matrix, const Viewport<T>& viewport, const std::vector<Vec3<T>>& points,
+			std::vector<Vec4<T>>& projected);
+
+	private:
+		static const size_t kGrainSize = 1 << 14;
+
+		static void Project(const Mat4<T>& matrix, const Vec3<T>& scale, const Vec3<T>& offset,
+			const std::vector<Vec3<T>>& points, std::vector<Vec4<T>>& projected);
 	};
 
 	template <typename T>
@@ -105,5 +149,99 @@ namespace Math
 	template <typename T>
 	Mat4<T>& Transform<T>::ScaleZ (const Mat4<T>& mat4, const T& z) {
 	}
-}
 
+	template <typename T>
+	Mat4<T> Transform<T>::Perspective (const T fovY, const T aspect, const T zNear, const T zFar) {
+		if (!(fovY > 0 && fovY < T(std::acos(-1.0))) || !(aspect > 0) || !(zNear > 0) || !(zFar > zNear))
+		{
+			throw std::invalid_argument("Invalid perspective projection");
+		}
+
+		const T f = T(1) / std::tan(fovY / 2);
+		return Mat4<T>(
+			f / aspect, 0, 0, 0,
+			0, f, 0, 0,
+			0, 0, (zFar + zNear) / (zNear - zFar), 2 * zFar * zNear / (zNear - zFar),
+			0, 0, -1, 0);
+	}
+
+	template <typename T>
+	Mat4<T> Transform<T>::Orthographic (const T left, const T right, const T bottom, const T top, const T zNear, const T zFar) {
+		if (!(right != left) || !(top != bottom) || !(zFar != zNear))
+		{
+			throw std::invalid_argument("Invalid orthographic projection");
+		}
+
+		return Mat4<T>(
+			2 / (right - left), 0, 0, -(right + left) / (right - left),
+			0, 2 / (top - bottom), 0, -(top + bottom) / (top - bottom),
+			0, 0, -2 / (zFar - zNear), -(zFar + zNear) / (zFar - zNear),
+			0, 0, 0, 1);
+	}
+
+	template <typename T>
+	Mat4<T> Transform<T>::LookAt (const Vec3<T>& eye, const Vec3<T>& target, const Vec3<T>& up) {
+		auto forward = target - eye;
+		const auto length = T(forward.Length());
+		if (!(length > 0))
+		{
+			throw std::invalid_argument("The eye is on the target");
+		}
+		forward /= length;
+
+		// Right is forward x up, the true up is right x forward
+		Vec3<T> right(forward.y * up.z - forward.z * up.y, forward.z * up.x - forward.x * up.z, forward.x * up.y - forward.y * up.x);
+		const auto rightLength = T(right.Length());
+		if (!(rightLength > 0))
+		{
+			throw std::invalid_argument("Up is along the view direction");
+		}
+		right /= rightLength;
+		const Vec3<T> trueUp(right.y * forward.z - right.z * forward.y, right.z * forward.x - right.x * forward.z,
+			right.x * forward.y - right.y * forward.x);
+
+		return Mat4<T>(
+			right.x, right.y, right.z, -Dot(right, eye),
+			trueUp.x, trueUp.y, trueUp.z, -Dot(trueUp, eye),
+			-forward.x, -forward.y, -forward.z, Dot(forward, eye),
+			0, 0, 0, 1);
+	}
+
+	template <typename T>
+	void Transform<T>::Project (const Mat4<T>& matrix, const std::vector<Vec3<T>>& points, std::vector<Vec4<T>>& projected) {
+		Project(matrix, Vec3<T>(1, 1, 1), Vec3<T>(0, 0, 0), points, projected);
+	}
+
+	template <typename T>
+	void Transform<T>::Project (const Mat4<T>& matrix, const Viewport<T>& viewport, const std::vector<Vec3<T>>& points,
+		std::vector<Vec4<T>>& projected) {
+		const Vec3<T> scale(viewport.width / 2, viewport.height / 2, (viewport.maxDepth - viewport.minDepth) / 2);
+		const Vec3<T> offset(viewport.x + scale.x, viewport.y + scale.y, (viewport.maxDepth + viewport.minDepth) / 2);
+		Project(matrix, scale, offset, points, projected);
+	}
+
+	template <typename T>
+	void Transform<T>::Project (const Mat4<T>& matrix, const Vec3<T>& scale, const Vec3<T>& offset,
+		const std::vector<Vec3<T>>& points, std::vector<Vec4<T>>& projected) {
+		projected.resize(points.size());
+		ParallelFor(points.size(), kGrainSize, [&](const size_t first, const size_t last) {
+			// The matrix and the viewport in registers, one division per point
+			const T m00 = matrix.v00, m10 = matrix.v10, m20 = matrix.v20, m30 = matrix.v30;
+			const T m01 = matrix.v01, m11 = matrix.v11, m21 = matrix.v21, m31 = matrix.v31;
+			const T m02 = matrix.v02, m12 = matrix.v12, m22 = matrix.v22, m32 = matrix.v32;
+			const T m03 = matrix.v03, m13 = matrix.v13, m23 = matrix.v23, m33 = matrix.v33;
+			const T sx = scale.x, sy = scale.y, sz = scale.z;
+			const T ox = offset.x, oy = offset.y, oz = offset.z;
+			for (size_t i = first; i < last; ++i)
+			{
+				const T x = points[i].x, y = points[i].y, z = points[i].z;
+				const T inverseW = T(1) / (m03 * x + m13 * y + m23 * z + m33);
+				projected[i] = Vec4<T>(
+					(m00 * x + m10 * y + m20 * z + m30) * inverseW * sx + ox,
+					(m01 * x + m11 * y + m21 * z + m31) * inverseW * sy + oy,
+					(m02 * x + m12 * y + m22 * z + m32) * inverseW * sz + oz,
+					inverseW);
+			}
+		});
+	}
+}
@@ -0,0 +1,101 @@
+﻿#include "ArcLengthTable.hpp"
+#include "BezierCurve.hpp"
+#include "MemoryResource.hpp"
+#include <algorithm>
+#include <stdexcept>
+
+namespace
+{
+	const unsigned kGaussPoints = 5;
+	const double kGaussNodes[kGaussPoints] = {
+		0.0, -0.5384693101056831, 0.5384693101056831, -0.9061798459386640, 0.9061798459386640
+	};
+	const double kGaussWeights[kGaussPoints] = {
+		0.5688888888888889, 0.4786286704993665, 0.4786286704993665, 0.2369268850561891, 0.2369268850561891
+	};
+}
+
+Math::ArcLengthTable::ArcLengthTable (const std::vector<Vec4d>& controlPoints, const unsigned nbSegments)
+	: mLengths(nbSegments + 1, 0.0), mParameters(nbSegments + 1, 0.0)
+{
+	if (nbSegments == 0)
+	{
+		throw std::invalid_argument("An arc length table needs at least one segment");
+	}
+
+	const auto step = 1.0 / nbSegments;
+	ScratchVector<double> parameters(nbSegments * kGaussPoints);
+	for (unsigned i = 0; i < nbSegments; ++i)
+	{
+		for (unsigned k = 0; k < kGaussPoints; ++k)
+		{
+			parameters[i * kGaussPoints + k] = (i + 0.5 * (1 + kGaussNodes[k])) * step;
+		}
+	}
+
+	ScratchVector<BezierSample> samples(parameters.size());
+	BezierCurve::EvaluateWithDerivatives(controlPoints, parameters.data(), parameters.size(), samples.data());
+	for (unsigned i = 0; i < nbSegments; ++i)
+	{
+		double length = 0;
+		for (unsigned k = 0; k < kGaussPoints; ++k)
+		{
+			length += kGaussWeights[k] * samples[i * kGaussPoints + k].derivative.Length();
+		}
+		mLengths[i + 1] = mLengths[i] + 0.5 * step * length;
+	}
+
+	for (unsigned i = 0; i <= nbSegments; ++i)
+	{
+		mParameters[i] = ParameterAtLength(Length() * i / nbSegments);
+	}
+}
+
+double Math::ArcLengthTable::Length () const
+{
+	return mLengths.back();
+}
+
+double Math::ArcLengthTable::LengthAt (const double u) const
+{
+	const auto nbSegments = mLengths.size() - 1;
+	const auto position = std::min(std::max(u, 0.0), 1.0) * nbSegments;
+	const auto i = std::min(size_t(position), nbSegments - 1);
+	return mLengths[i] + (position - i) * (mLengths[i + 1] - mLengths[i]);
+}
+
+double Math::ArcLengthTable::ParameterAtLength (const double length) const
+{
+	if (length <= 0)
+	{
+		return 0;
+	}
+	if (length >= Length())
+	{
+		return 1;
+	}
+
+	const auto nbSegments = mLengths.size() - 1;
+	const auto i = size_t(std::upper_bound(mLengths.begin(), mLengths.end(), length) - mLengths.begin()) - 1;
+	const auto segment = mLengths[i + 1] - mLengths[i];
+	const auto t = segment > 0 ? (length - mLengths[i]) / segment : 0.0;
+	return (i + t) / nbSegments;
+}
+
+double Math::ArcLengthTable::ParameterAtLengthFast (const double length) const
+{
+	const auto total = Length();
+	if (length <= 0 || total <= 0)
+	{
+		return 0;
+	}
+	if (length >= total)
+	{
+		return 1;
+	}
+
+	const auto nbSegments = mParameters.size() - 1;
+	const auto position = length / total * nbSegments;
+	const auto i = std::min(size_t(position), nbSegments - 1);
+	return mParameters[i] + (position - i) * (mParameters[i + 1] - mParameters[i]);
+}
@@ -0,0 +1,181 @@
+﻿#include "BernsteinBasis.hpp"
+#include "MemoryResource.hpp"
+#include <algorithm>
+#include <deque>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+
+namespace
+{
+	const size_t kCacheSize = 64;
+	const size_t kThreadCacheSize = 4;
+
+	typedef std::pair<unsigned, unsigned> BasisKey;
+	typedef std::pair<BasisKey, std::shared_ptr<const Math::BernsteinBasis>> CachedBasis;
+}
+
+Math::BernsteinBasis::BernsteinBasis (const unsigned degree, const unsigned nbPoints)
+	: mDegree(degree), mNbSamples(nbPoints + 2), mWeights((degree + 1) * (nbPoints + 2))
+{
+	ScratchVector<double> values(degree + 1);
+
+	for (unsigned s = 0; s < mNbSamples; ++s)
+	{
+		Evaluate(degree, Parameter(s), values.data());
+		for (unsigned i = 0; i <= degree; ++i)
+		{
+			mWeights[i * mNbSamples + s] = values[i];
+		}
+	}
+}
+
+std::shared_ptr<const Math::BernsteinBasis> Math::BernsteinBasis::Get (const unsigned degree, const unsigned nbPoints)
+{
+	// Tables this thread got last, most recent first
+	static thread_local CachedBasis recent[kThreadCacheSize];
+
+	const auto key = std::make_pair(degree, nbPoints);
+	for (size_t i = 0; i < kThreadCacheSize; ++i)
+	{
+		if (recent[i].second && recent[i].first == key)
+		{
+			std::rotate(recent, recent + i, recent + i + 1);
+			return recent[0].second;
+		}
+	}
+
+	std::shared_ptr<const BernsteinBasis> basis;
+	{
+		static std::map<BasisKey, std::shared_ptr<const BernsteinBasis>> cache;
+		static std::deque<BasisKey> built; /// Keys of cache, oldest first
+		static std::mutex mutex;
+
+		std::lock_guard<std::mutex> lock(mutex);
+		auto& cached = cache[key];
+		if (!cached)
+		{
+			cached = std::make_shared<BernsteinBasis>(degree, nbPoints);
+			built.push_back(key);
+		}
+		basis = cached;
+		if (built.size() > kCacheSize)
+		{
+			cache.erase(built.front());
+			built.pop_front();
+		}
+	}
+
+	std::rotate(recent, recent + kThreadCacheSize - 1, recent + kThreadCacheSize);
+	recent[0] = CachedBasis(key, basis);
+	return basis;
+}
+
+void Math::BernsteinBasis::Evaluate (const unsigned degree, const double u, double* values)
+{
+	// Same triangle as de Casteljau, run on the weights instead of the points
+	values[0] = 1;
+	for (unsigned j = 1; j <= degree; ++j)
+	{
+		values[j] = u * values[j - 1];
+		for (unsigned i = j - 1; i > 0; --i)
+		{
+			values[i] = (1 - u) * values[i] + u * values[i - 1];
+		}
+		values[0] = (1 - u) * values[0];
+	}
+}
+
+void Math::BernsteinBasis::Evaluate (const unsigned degree, const double u, double* values, double* derivatives)
+{
+	if (degree == 0)
+	{
+		values[0] = 1;
+		derivatives[0] = 0;
+		return;
+	}
+
+	// B'(i, n) = n * (B(i - 1, n - 1) - B(i, n - 1)), then raise the values to degree n
+	Evaluate(degree - 1, u, values);
+	for (unsigned i = 0; i <= degree; ++i)
+	{
+		const auto previous = i > 0 ? values[i - 1] : 0.0;
+		const auto current = i < degree ? values[i] : 0.0;
+		derivatives[i] = degree * (previous - current);
+	}
+
+	values[degree] = u * values[degree - 1];
+	for (unsigned i = degree - 1; i > 0; --i)
+	{
+		values[i] = (1 - u) * values[i] + u * values[i - 1];
+	}
+	values[0] = (1 - u) * values[0];
+}
+
+unsigned Math::BernsteinBasis::Degree () const
+{
+	return mDegree;
+}
+
+unsigned Math::BernsteinBasis::NbSamples () const
+{
+	return mNbSamples;
+}
+
+double Math::BernsteinBasis::Parameter (const unsigned sample) const
+{
+	return double(sample) / double(mNbSamples - 1);
+}
+
+const double* Math::BernsteinBasis::Column (const unsigned controlPoint) const
+{
+	return mWeights.data() + controlPoint * mNbSamples;
+}
+
+std::vector<Math::Vec3d> Math::BernsteinBasis::Apply (const std::vector<Vec4d>& controlPoints) const
+{
+	if (controlPoints.size() != mDegree + 1)
+	{
+		throw std::invalid_argument("Control point count does not match the basis degree");
+	}
+
+	std::vector<Vec3d> curve(mNbSamples);
+	Apply(controlPoints.data(), curve.data());
+	return curve;
+}
+
+void Math::BernsteinBasis::Apply (const Vec4d* controlPoints, Vec3d* curve) const
+{
+	// One accumulator row per homogeneous coordinate, the inner loop is a plain axpy over the samples
+	ScratchVector<double> accumulators(4 * mNbSamples, 0.0);
+	double* x = accumulators.data();
+	double* y = x + mNbSamples;
+	double* z = y + mNbSamples;
+	double* w = z + mNbSamples;
+
+	for (unsigned i = 0; i <= mDegree; ++i)
+	{
+		const double* column = Column(i);
+		const auto& point = controlPoints[i];
+		const auto px = point.w * point.x;
+		const auto py = point.w * point.y;
+		const auto pz = point.w * point.z;
+		const auto pw = point.w;
+
+		for (unsigned s = 0; s < mNbSamples; ++s)
+		{
+			x[s] += column[s] * px;
+			y[s] += column[s] * py;
+			z[s] += column[s] * pz;
+			w[s] += column[s] * pw;
+		}
+	}
+
+	curve[0] = Vec3d(controlPoints[0]);
+	for (unsigned s = 1; s + 1 < mNbSamples; ++s)
+	{
+		curve[s] = Vec3d(x[s] / w[s], y[s] / w[s], z[s] / w[s]);
+	}
+	curve[mNbSamples - 1] = Vec3d(controlPoints[mDegree]);
+}
@@ -1,5 +1,365 @@
 ﻿#include "BezierCurve.hpp"
 #include "Vec2.hpp"
+#include "BernsteinBasis.hpp"
+#include "FixedBezierCurve.hpp"
+#include "MemoryResource.hpp"
+#include "Parallel.hpp"
+#include <algorithm>
+#include <stdexcept>
+
+namespace
+{
+	const unsigned kMaxSubdivisionDepth = 16;
+	const unsigned kBoundsPieces = 16;
+	const unsigned kNewtonSteps = 3;
+	const double kRootWidth = 1e-10;
+	const unsigned kBatchLanes = 4;
+	const size_t kBatchGrainSize = 256;
+
+	Math::Vec4d ToHomogeneous (const Math::Vec4d& point)
+	{
+		return Math::Vec4d(point.w * point.x, point.w * point.y, point.w * point.z, point.w);
+	}
+
+	Math::Vec3d Project (const Math::Vec4d& homogeneous)
+	{
+		return Math::Vec3d(homogeneous) / homogeneous.w;
+	}
+
+	Math::Vec4d FromHomogeneous (const Math::Vec4d& homogeneous)
+	{
+		return Math::Vec4d(homogeneous.x / homogeneous.w, homogeneous.y / homogeneous.w, homogeneous.z / homogeneous.w, homogeneous.w);
+	}
+
+	void HullBox (const Math::Vec4d* homogeneous, const size_t count, Math::Vec3d& min, Math::Vec3d& max)
+	{
+		min = max = Project(homogeneous[0]);
+		for (size_t i = 1; i < count; ++i)
+		{
+			const auto point = Project(homogeneous[i]);
+			min = Math::Vec3d(std::min(min.x, point.x), std::min(min.y, point.y), std::min(min.z, point.z));
+			max = Math::Vec3d(std::max(max.x, point.x), std::max(max.y, point.y), std::max(max.z, point.z));
+		}
+	}
+
+	double DistanceToBox (const Math::Vec3d& point, const Math::Vec3d& min, const Math::Vec3d& max)
+	{
+		const Math::Vec3d clamped(
+			std::min(std::max(point.x, min.x), max.x),
+			std::min(std::max(point.y, min.y), max.y),
+			std::min(std::max(point.z, min.z), max.z));
+		return (clamped - point).Length();
+	}
+
+	/**
+	 * Append the roots in ]0, 1[ of a one dimensional Bernstein polynomial.
+	 * \details Intervals whose coefficients share a sign cannot hold a root and are dropped,
+	 *	the others are halved until narrower than kRootWidth.
+	 */
+	void BernsteinRoots (const Math::ScratchVector<double>& coefficients, Math::ScratchVector<double>& roots)
+	{
+		const auto count = coefficients.size();
+		if (std::all_of(coefficients.begin(), coefficients.end(), [](double c) { return c == 0; }))
+		{
+			return;
+		}
+
+		Math::ScratchVector<double> pieces(coefficients.begin(), coefficients.end());
+		Math::ScratchVector<double> left(count);
+		Math::ScratchVector<std::pair<double, double>> ranges(1, std::make_pair(0.0, 1.0));
+
+		while (!ranges.empty())
+		{
+			const auto range = ranges.back();
+			const auto offset = pieces.size() - count;
+			ranges.pop_back();
+
+			const auto minmax = std::minmax_element(pieces.begin() + offset, pieces.end());
+			if (*minmax.first > 0 || *minmax.second < 0)
+			{
+				pieces.resize(offset);
+				continue;
+			}
+			if (range.second - range.first < kRootWidth)
+			{
+				const auto root = 0.5 * (range.first + range.second);
+				if (root > 0 && root < 1 && (roots.empty() || std::abs(root - roots.back()) > kRootWidth))
+				{
+					roots.push_back(root);
+				}
+				pieces.resize(offset);
+				continue;
+			}
+
+			// Halve in place, the right half replaces the piece and the left one is pushed after it
+			left[0] = pieces[offset];
+			for (size_t j = 1; j < count; ++j)
+			{
+				for (size_t i = 0; i < count - j; ++i)
+				{
+					pieces[offset + i] = 0.5 * (pieces[offset + i] + pieces[offset + i + 1]);
+				}
+				left[j] = pieces[offset];
+			}
+			pieces.insert(pieces.end(), left.begin(), left.end());
+
+			const auto middle = 0.5 * (range.first + range.second);
+			ranges.push_back(std::make_pair(middle, range.second));
+			ranges.push_back(std::make_pair(range.first, middle));
+		}
+	}
+
+	/**
+	 * Split homogeneous control points at u.
+	 * \details right is used as the de Casteljau triangle, its last written value
+	 *	on each level is exactly the matching control point of the right half.
+	 */
+	void Subdivide (const Math::Vec4d* points, const size_t count, const double u, Math::Vec4d* left, Math::Vec4d* right)
+	{
+		std::copy(points, points + count, right);
+		left[0] = right[0];
+
+		for (size_t j = 1; j < count; ++j)
+		{
+			for (size_t i = 0; i < count - j; ++i)
+			{
+				right[i] = (1 - u) * right[i] + u * right[i + 1];
+			}
+			left[j] = right[0];
+		}
+	}
+
+	double DistanceToSegment (const Math::Vec3d& point, const Math::Vec3d& a, const Math::Vec3d& b)
+	{
+		const auto ab = b - a;
+		const auto ap = point - a;
+		const auto length2 = Math::Dot(ab, ab);
+		const auto t = length2 > 0 ? std::min(1.0, std::max(0.0, Math::Dot(ap, ab) / length2)) : 0.0;
+		return (ap - t * ab).Length();
+	}
+
+	/**
+	 * Largest distance between the inner control points and the chord.
+	 * \details With positive weights the curve lies in the hull of its control points,
+	 *	so this bounds the distance between the curve and the chord.
+	 */
+	double Flatness (const Math::Vec4d* homogeneous, const size_t count)
+	{
+		const auto first = Project(homogeneous[0]);
+		const auto last = Project(homogeneous[count - 1]);
+		double flatness = 0;
+
+		for (size_t i = 1; i + 1 < count; ++i)
+		{
+			flatness = std::max(flatness, DistanceToSegment(Project(homogeneous[i]), first, last));
+		}
+		return flatness;
+	}
+
+	/**
+	 * Evaluate homogeneous control points and their derivatives at u, temp must hold count points.
+	 */
+	Math::BezierSample EvaluateHomogeneous (const Math::Vec4d* homogeneous, const size_t count, const double u, Math::Vec4d* temp)
+	{
+		const auto degree = double(count - 1);
+		Math::Vec4d first;
+		Math::Vec4d second;
+
+		std::copy(homogeneous, homogeneous + count, temp);
+		for (size_t j = 1; j < count; ++j)
+		{
+			if (j + 2 == count)
+			{
+				second = degree * (degree - 1) * (temp[2] - 2.0 * temp[1] + temp[0]);
+			}
+			if (j + 1 == count)
+			{
+				first = degree * (temp[1] - temp[0]);
+			}
+
+			for (size_t i = 0; i < count - j; ++i)
+			{
+				temp[i] = (1 - u) * temp[i] + u * temp[i + 1];
+			}
+		}
+
+		// Quotient rule on (x, y, z) / w
+		const auto w = temp[0].w;
+		Math::BezierSample sample;
+		sample.position = Math::Vec3d(temp[0]) / w;
+		sample.derivative = (Math::Vec3d(first) - first.w * sample.position) / w;
+		sample.secondDerivative = (Math::Vec3d(second) - 2.0 * first.w * sample.derivative - second.w * sample.position) / w;
+
+		const auto speed = sample.derivative.Length();
+		sample.curvature = speed > 0 ? (sample.derivative * sample.secondDerivative).Length() / (speed * speed * speed) : 0.0;
+		return sample;
+	}
+
+	/**
+	 * Closest point search shared by ClosestPoint and HitTest, it returns as soon as
+	 *	a point closer than stopDistance is found.
+	 */
+	Math::BezierProjection SearchClosest (const std::vector<Math::Vec4d>& controlPoints, const Math::Vec3d& point,
+		const double tolerance, const double stopDistance)
+	{
+		if (controlPoints.empty())
+		{
+			throw std::invalid_argument("A curve needs at least one control point");
+		}
+		if (tolerance <= 0)
+		{
+			throw std::invalid_argument("Tolerance must be positive");
+		}
+
+		struct Range
+		{
+			double first;
+			double last;
+			unsigned depth;
+		};
+
+		const auto count = controlPoints.size();
+		Math::ScratchVector<Math::Vec4d> homogeneous(count);
+		Math::ScratchVector<Math::Vec4d> temp(count);
+		std::transform(controlPoints.begin(), controlPoints.end(), homogeneous.begin(), ToHomogeneous);
+
+		Math::BezierProjection best;
+		best.parameter = 0;
+		best.position = Math::Vec3d(controlPoints[0]);
+		best.distance = (best.position - point).Length();
+		const Math::Vec3d last(controlPoints[count - 1]);
+		if ((last - point).Length() < best.distance)
+		{
+			best.parameter = 1;
+			best.position = last;
+			best.distance = (last - point).Length();
+		}
+
+		Math::ScratchVector<Math::Vec4d> pieces(homogeneous);
+		Math::ScratchVector<Math::Vec4d> halves(2 * count);
+		Math::ScratchVector<Range> ranges(1, Range{ 0.0, 1.0, 0 });
+
+		while (!ranges.empty() && best.distance > stopDistance)
+		{
+			const auto range = ranges.back();
+			const auto offset = pieces.size() - count;
+			ranges.pop_back();
+
+			Math::Vec3d min, max;
+			HullBox(&pieces[offset], count, min, max);
+			if (DistanceToBox(point, min, max) >= best.distance)
+			{
+				pieces.resize(offset);
+				continue;
+			}
+
+			if (range.depth >= kMaxSubdivisionDepth || Flatness(&pieces[offset], count) <= tolerance)
+			{
+				// Start from the projection on the chord, then run Newton on (P(u) - point).P'(u) = 0
+				const auto a = Project(pieces[offset]);
+				const auto ab = Project(pieces[offset + count - 1]) - a;
+				const auto length2 = Math::Dot(ab, ab);
+				const auto t = length2 > 0 ? std::min(1.0, std::max(0.0, Math::Dot(point - a, ab) / length2)) : 0.0;
+				auto u = range.first + t * (range.last - range.first);
+
+				for (unsigned step = 0; step <= kNewtonSteps; ++step)
+				{
+					const auto sample = EvaluateHomogeneous(homogeneous.data(), count, u, temp.data());
+					const auto delta = sample.position - point;
+					const auto distance = delta.Length();
+					if (distance < best.distance)
+					{
+						best.parameter = u;
+						best.position = sample.position;
+						best.distance = distance;
+					}
+
+					const auto slope = Math::Dot(sample.derivative, sample.derivative) + Math::Dot(delta, sample.secondDerivative);
+					if (slope <= 0)
+					{
+						break;
+					}
+					u = std::min(range.last, std::max(range.first, u - Math::Dot(delta, sample.derivative) / slope));
+				}
+
+				pieces.resize(offset);
+				continue;
+			}
+
+			Subdivide(&pieces[offset], count, 0.5, &halves[count], &halves[0]);
+			pieces.resize(offset + 2 * count);
+			std::copy(halves.begin(), halves.end(), pieces.begin() + offset);
+
+			const auto middle = 0.5 * (range.first + range.last);
+			ranges.push_back(Range{ middle, range.last, range.depth + 1 });
+			ranges.push_back(Range{ range.first, middle, range.depth + 1 });
+		}
+
+		return best;
+	}
+
+	template <unsigned N>
+	std::vector<Math::Vec3d> ComputeFixed (const std::vector<Math::Vec4d>& controlPoints, const unsigned nbPoints)
+	{
+		std::array<Math::Vec4d, N + 1> points;
+		std::copy(controlPoints.begin(), controlPoints.end(), points.begin());
+		return Math::FixedBezierCurve<N, double>(points).Compute(nbPoints);
+	}
+
+	/**
+	 * Sample kBatchLanes curves of the same degree, lane l reading its control points from points[l].
+	 * \details accumulators holds 4 * NbSamples() * kBatchLanes values, the innermost loop
+	 *	runs over the lanes so every basis weight is broadcast to all the curves at once.
+	 */
+	void ComputeLanes (const Math::BernsteinBasis& basis, const Math::Vec4d* const* points,
+		Math::Vec3d* const* curves, Math::ScratchVector<double>& accumulators)
+	{
+		const unsigned nbSamples = basis.NbSamples();
+		const unsigned stride = nbSamples * kBatchLanes;
+		accumulators.assign(4 * stride, 0.0);
+		double* x = accumulators.data();
+		double* y = x + stride;
+		double* z = y + stride;
+		double* w = z + stride;
+
+		for (unsigned i = 0; i <= basis.Degree(); ++i)
+		{
+			double hx[kBatchLanes], hy[kBatchLanes], hz[kBatchLanes], hw[kBatchLanes];
+			for (unsigned l = 0; l < kBatchLanes; ++l)
+			{
+				const auto& point = points[l][i];
+				hx[l] = point.w * point.x;
+				hy[l] = point.w * point.y;
+				hz[l] = point.w * point.z;
+				hw[l] = point.w;
+			}
+
+			const double* column = basis.Column(i);
+			for (unsigned s = 0; s < nbSamples; ++s)
+			{
+				const auto b = column[s];
+				for (unsigned l = 0; l < kBatchLanes; ++l)
+				{
+					x[s * kBatchLanes + l] += b * hx[l];
+					y[s * kBatchLanes + l] += b * hy[l];
+					z[s * kBatchLanes + l] += b * hz[l];
+					w[s * kBatchLanes + l] += b * hw[l];
+				}
+			}
+		}
+
+		for (unsigned l = 0; l < kBatchLanes; ++l)
+		{
+			curves[l][0] = Math::Vec3d(points[l][0]);
+			for (unsigned s = 1; s + 1 < nbSamples; ++s)
+			{
+				const auto k = s * kBatchLanes + l;
+				curves[l][s] = Math::Vec3d(x[k] / w[k], y[k] / w[k], z[k] / w[k]);
+			}
+			curves[l][nbSamples - 1] = Math::Vec3d(points[l][basis.Degree()]);
+		}
+	}
+}
 
 std::vector<Math::Vec3d> Math::BezierCurve::ComputeWithDeCasteljau (
 	const std::vector<Vec4d>& controlPoints, const unsigned nbPoints)
@@ -8,7 +368,7 @@ std::vector<Math::Vec3d> Math::BezierCurve::ComputeWithDeCasteljau (
 	curve[0] = Vec3d(controlPoints[0]);
 	curve[curve.size() - 1] = Vec3d(controlPoints[controlPoints.size() - 1]);
 
-	std::vector<Vec4d> temp_points(controlPoints.size());
+	ScratchVector<Vec4d> temp_points(controlPoints.size());
 	
 	const auto step = 1.0 / (double(nbPoints) + 1.0);
 	size_t index = 1;
@@ -32,5 +392,306 @@ std::vector<Math::Vec3d> Math::BezierCurve::ComputeWithDeCasteljau (
 		curve[index] = Vec3d(temp_points[0]) / temp_points[0].w;
 	}
 
-	return move(curve);
+	return curve;
+}
+
+std::vector<Math::Vec3d> Math::BezierCurve::ComputeWithFixedDegree (
+	const std::vector<Vec4d>& controlPoints, const unsigned nbPoints)
+{
+	// Lines, quadratics and cubics go through the unrolled evaluators
+	switch (controlPoints.size())
+	{
+	case 2:
+		return ComputeFixed<1>(controlPoints, nbPoints);
+	case 3:
+		return ComputeFixed<2>(controlPoints, nbPoints);
+	case 4:
+		return ComputeFixed<3>(controlPoints, nbPoints);
+	default:
+		return ComputeWithDeCasteljau(controlPoints, nbPoints);
+	}
+}
+
+std::vector<Math::Vec3d> Math::BezierCurve::ComputeWithBasis (
+	const std::vector<Vec4d>& controlPoints, const unsigned nbPoints)
+{
+	if (controlPoints.empty())
+	{
+		throw std::invalid_argument("A curve needs at least one control point");
+	}
+
+	return BernsteinBasis::Get(unsigned(controlPoints.size()) - 1, nbPoints)->Apply(controlPoints);
+}
+
+std::vector<Math::Vec3d> Math::BezierCurve::ComputeAdaptive (
+	const std::vector<Vec4d>& controlPoints, const double tolerance)
+{
+	if (controlPoints.empty())
+	{
+		throw std::invalid_argument("A curve needs at least one control point");
+	}
+	if (tolerance <= 0)
+	{
+		throw std::invalid_argument("Tolerance must be positive");
+	}
+
+	const auto count = controlPoints.size();
+	std::vector<Vec3d> curve(1, Vec3d(controlPoints[0]));
+
+	// Pieces still to test, stored back to back; the left half is pushed last so it is handled first
+	ScratchVector<Vec4d> pieces(count);
+	ScratchVector<Vec4d> halves(2 * count);
+	ScratchVector<unsigned> depths(1, 0);
+	std::transform(controlPoints.begin(), controlPoints.end(), pieces.begin(), ToHomogeneous);
+
+	while (!depths.empty())
+	{
+		const auto depth = depths.back();
+		const auto offset = pieces.size() - count;
+
+		if (depth >= kMaxSubdivisionDepth || Flatness(&pieces[offset], count) <= tolerance)
+		{
+			curve.push_back(Project(pieces[offset + count - 1]));
+			pieces.resize(offset);
+			depths.pop_back();
+			continue;
+		}
+
+		Subdivide(&pieces[offset], count, 0.5, &halves[count], &halves[0]);
+		pieces.resize(offset + 2 * count);
+		std::copy(halves.begin(), halves.end(), pieces.begin() + offset);
+
+		depths.back() = depth + 1;
+		depths.push_back(depth + 1);
+	}
+
+	curve.back() = Vec3d(controlPoints[count - 1]);
+	return curve;
+}
+
+void Math::BezierCurve::ComputeBatch (const std::vector<Vec4d>& controlPoints, const std::vector<size_t>& offsets,
+	const unsigned nbPoints, std::vector<Vec3d>& curve)
+{
+	const size_t nbCurves = offsets.empty() ? 0 : offsets.size() - 1;
+	for (size_t i = 0; i < nbCurves; ++i)
+	{
+		if (offsets[i] >= offsets[i + 1] || offsets[i + 1] > controlPoints.size())
+		{
+			throw std::invalid_argument("Invalid control point offsets");
+		}
+	}
+
+	const size_t stride = nbPoints + 2;
+	curve.resize(nbCurves * stride);
+
+	ParallelFor(nbCurves, kBatchGrainSize, [&](const size_t first, const size_t last) {
+		std::shared_ptr<const BernsteinBasis> basis;
+		ScratchVector<double> accumulators;
+		size_t i = first;
+
+		while (i < last)
+		{
+			const auto degree = unsigned(offsets[i + 1] - offsets[i] - 1);
+			if (!basis || basis->Degree() != degree)
+			{
+				basis = BernsteinBasis::Get(degree, nbPoints);
+			}
+
+			size_t run = 1;
+			while (run < kBatchLanes && i + run < last && offsets[i + run + 1] - offsets[i + run] == degree + 1)
+			{
+				++run;
+			}
+
+			if (run == kBatchLanes)
+			{
+				const Vec4d* points[kBatchLanes];
+				Vec3d* curves[kBatchLanes];
+				for (unsigned l = 0; l < kBatchLanes; ++l)
+				{
+					points[l] = &controlPoints[offsets[i + l]];
+					curves[l] = &curve[(i + l) * stride];
+				}
+				ComputeLanes(*basis, points, curves, accumulators);
+			}
+			else
+			{
+				for (size_t k = i; k < i + run; ++k)
+				{
+					basis->Apply(&controlPoints[offsets[k]], &curve[k * stride]);
+				}
+			}
+			i += run;
+		}
+	});
+}
+
+Math::BezierSample Math::BezierCurve::EvaluateWithDerivatives (const std::vector<Vec4d>& controlPoints, const double u)
+{
+	if (controlPoints.empty())
+	{
+		throw std::invalid_argument("A curve needs at least one control point");
+	}
+
+	ScratchVector<Vec4d> homogeneous(controlPoints.size());
+	ScratchVector<Vec4d> temp(controlPoints.size());
+	std::transform(controlPoints.begin(), controlPoints.end(), homogeneous.begin(), ToHomogeneous);
+
+	return EvaluateHomogeneous(homogeneous.data(), homogeneous.size(), u, temp.data());
+}
+
+std::vector<Math::BezierSample> Math::BezierCurve::EvaluateWithDerivatives (
+	const std::vector<Vec4d>& controlPoints, const std::vector<double>& parameters)
+{
+	std::vector<BezierSample> samples(parameters.size());
+	EvaluateWithDerivatives(controlPoints, parameters.data(), parameters.size(), samples.data());
+	return samples;
+}
+
+void Math::BezierCurve::EvaluateWithDerivatives (const std::vector<Vec4d>& controlPoints,
+	const double* parameters, const size_t count, BezierSample* samples)
+{
+	if (controlPoints.empty())
+	{
+		throw std::invalid_argument("A curve needs at least one control point");
+	}
+
+	ScratchVector<Vec4d> homogeneous(controlPoints.size());
+	ScratchVector<Vec4d> temp(controlPoints.size());
+	std::transform(controlPoints.begin(), controlPoints.end(), homogeneous.begin(), ToHomogeneous);
+
+	for (size_t i = 0; i < count; ++i)
+	{
+		samples[i] = EvaluateHomogeneous(homogeneous.data(), homogeneous.size(), parameters[i], temp.data());
+	}
+}
+
+std::vector<Math::BezierSample> Math::BezierCurve::ComputeWithDerivatives (
+	const std::vector<Vec4d>& controlPoints, const unsigned nbPoints)
+{
+	if (controlPoints.empty())
+	{
+		throw std::invalid_argument("A curve needs at least one control point");
+	}
+
+	ScratchVector<Vec4d> homogeneous(controlPoints.size());
+	ScratchVector<Vec4d> temp(controlPoints.size());
+	std::transform(controlPoints.begin(), controlPoints.end(), homogeneous.begin(), ToHomogeneous);
+
+	std::vector<BezierSample> curve(nbPoints + 2);
+	const auto step = 1.0 / (double(nbPoints) + 1.0);
+
+	for (unsigned index = 0; index < curve.size(); ++index)
+	{
+		curve[index] = EvaluateHomogeneous(homogeneous.data(), homogeneous.size(), index * step, temp.data());
+	}
+
+	return curve;
+}
+
+void Math::BezierCurve::Split (const std::vector<Vec4d>& controlPoints, const double u,
+	std::vector<Vec4d>& left, std::vector<Vec4d>& right)
+{
+	if (controlPoints.empty())
+	{
+		throw std::invalid_argument("A curve needs at least one control point");
+	}
+
+	const auto count = controlPoints.size();
+	ScratchVector<Vec4d> homogeneous(count);
+	std::transform(controlPoints.begin(), controlPoints.end(), homogeneous.begin(), ToHomogeneous);
+
+	left.resize(count);
+	right.resize(count);
+	Subdivide(homogeneous.data(), count, u, left.data(), right.data());
+
+	std::transform(left.begin(), left.end(), left.begin(), FromHomogeneous);
+	std::transform(right.begin(), right.end(), right.begin(), FromHomogeneous);
+}
+
+void Math::BezierCurve::HullBounds (const std::vector<Vec4d>& controlPoints, Vec3d& min, Vec3d& max)
+{
+	if (controlPoints.empty())
+	{
+		throw std::invalid_argument("A curve needs at least one control point");
+	}
+
+	ScratchVector<Vec4d> homogeneous(controlPoints.size());
+	std::transform(controlPoints.begin(), controlPoints.end(), homogeneous.begin(), ToHomogeneous);
+	HullBox(homogeneous.data(), homogeneous.size(), min, max);
+}
+
+void Math::BezierCurve::Bounds (const std::vector<Vec4d>& controlPoints, Vec3d& min, Vec3d& max)
+{
+	if (controlPoints.empty())
+	{
+		throw std::invalid_argument("A curve needs at least one control point");
+	}
+
+	const auto count = controlPoints.size();
+	const auto weight = controlPoints[0].w;
+	const auto rational = std::any_of(controlPoints.begin(), controlPoints.end(),
+		[weight](const Vec4d& point) { return point.w != weight; });
+
+	ScratchVector<Vec4d> homogeneous(count);
+	ScratchVector<Vec4d> temp(count);
+	std::transform(controlPoints.begin(), controlPoints.end(), homogeneous.begin(), ToHomogeneous);
+
+	if (rational)
+	{
+		ScratchVector<Vec4d> left(count);
+		ScratchVector<Vec4d> right(count);
+		ScratchVector<Vec4d> piece(homogeneous);
+		min = max = Vec3d(controlPoints[0]);
+
+		for (unsigned i = 0; i < kBoundsPieces; ++i)
+		{
+			// Peel [i / n, (i + 1) / n] off the remaining curve
+			Subdivide(piece.data(), count, 1.0 / (kBoundsPieces - i), left.data(), right.data());
+			Vec3d pieceMin, pieceMax;
+			HullBox(left.data(), count, pieceMin, pieceMax);
+			min = Vec3d(std::min(min.x, pieceMin.x), std::min(min.y, pieceMin.y), std::min(min.z, pieceMin.z));
+			max = Vec3d(std::max(max.x, pieceMax.x), std::max(max.y, pieceMax.y), std::max(max.z, pieceMax.z));
+			piece.swap(right);
+		}
+		return;
+	}
+
+	min = max = Vec3d(controlPoints[0]);
+	const Vec3d last(controlPoints[count - 1]);
+	min = Vec3d(std::min(min.x, last.x), std::min(min.y, last.y), std::min(min.z, last.z));
+	max = Vec3d(std::max(max.x, last.x), std::max(max.y, last.y), std::max(max.z, last.z));
+
+	ScratchVector<double> coefficients(count - 1);
+	ScratchVector<double> roots;
+	for (unsigned axis = 0; axis < 3 && count > 2; ++axis)
+	{
+		for (size_t i = 0; i + 1 < count; ++i)
+		{
+			coefficients[i] = controlPoints[i + 1][axis] - controlPoints[i][axis];
+		}
+		BernsteinRoots(coefficients, roots);
+	}
+
+	for (const auto root : roots)
+	{
+		const auto point = EvaluateHomogeneous(homogeneous.data(), count, root, temp.data()).position;
+		min = Vec3d(std::min(min.x, point.x), std::min(min.y, point.y), std::min(min.z, point.z));
+		max = Vec3d(std::max(max.x, point.x), std::max(max.y, point.y), std::max(max.z, point.z));
+	}
+}
+
+Math::BezierProjection Math::BezierCurve::ClosestPoint (const std::vector<Vec4d>& controlPoints,
+	const Vec3d& point, const double tolerance)
+{
+	return SearchClosest(controlPoints, point, tolerance, 0.0);
+}
+
+bool Math::BezierCurve::HitTest (const std::vector<Vec4d>& controlPoints, const Vec3d& point, const double radius)
+{
+	if (radius <= 0)
+	{
+		throw std::invalid_argument("Radius must be positive");
+	}
+	return SearchClosest(controlPoints, point, 1e-3 * radius, radius).distance <= radius;
 }
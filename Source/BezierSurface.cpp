@@ -0,0 +1,147 @@
+﻿#include "BezierSurface.hpp"
+#include "BernsteinBasis.hpp"
+#include "MemoryResource.hpp"
+#include "Parallel.hpp"
+#include <stdexcept>
+
+namespace
+{
+	const size_t kRowGrainSize = 8;
+	const double kDegenerateNormal = 1e-12;
+	const double kNormalOffset = 1e-6;
+
+	struct Frame
+	{
+		Math::Vec3d position;
+		Math::Vec3d du;
+		Math::Vec3d dv;
+	};
+
+	/**
+	 * Position and partial derivatives from homogeneous values, quotient rule on (x, y, z) / w.
+	 */
+	Frame ToFrame (const Math::Vec4d& s, const Math::Vec4d& su, const Math::Vec4d& sv)
+	{
+		Frame frame;
+		frame.position = Math::Vec3d(s) / s.w;
+		frame.du = (Math::Vec3d(su) - su.w * frame.position) / s.w;
+		frame.dv = (Math::Vec3d(sv) - sv.w * frame.position) / s.w;
+		return frame;
+	}
+
+	Frame EvaluateFrame (const Math::Vec4d* homogeneous, const unsigned nbRows, const unsigned nbColumns,
+		const double u, const double v)
+	{
+		Math::ScratchVector<double> bu(nbRows), dbu(nbRows), bv(nbColumns), dbv(nbColumns);
+		Math::BernsteinBasis::Evaluate(nbRows - 1, u, bu.data(), dbu.data());
+		Math::BernsteinBasis::Evaluate(nbColumns - 1, v, bv.data(), dbv.data());
+
+		Math::Vec4d s, su, sv;
+		for (unsigned r = 0; r < nbRows; ++r)
+		{
+			for (unsigned c = 0; c < nbColumns; ++c)
+			{
+				const auto& point = homogeneous[r * nbColumns + c];
+				s += (bu[r] * bv[c]) * point;
+				su += (dbu[r] * bv[c]) * point;
+				sv += (bu[r] * dbv[c]) * point;
+			}
+		}
+		return ToFrame(s, su, sv);
+	}
+
+	/**
+	 * Basis values and derivatives of every sample, resolution rows of degree + 1 weights.
+	 */
+	void SampleBasis (const unsigned degree, const unsigned resolution, Math::ScratchVector<double>& values, Math::ScratchVector<double>& derivatives)
+	{
+		values.resize(resolution * (degree + 1));
+		derivatives.resize(resolution * (degree + 1));
+		for (unsigned i = 0; i < resolution; ++i)
+		{
+			const auto u = double(i) / double(resolution - 1);
+			Math::BernsteinBasis::Evaluate(degree, u, &values[i * (degree + 1)], &derivatives[i * (degree + 1)]);
+		}
+	}
+}
+
+void Math::BezierSurface::Tessellate (const std::vector<Vec4d>& controlPoints, const unsigned nbRows, const unsigned nbColumns,
+	const unsigned resolutionU, const unsigned resolutionV, std::vector<Vec3d>& positions, std::vector<Vec3d>& normals)
+{
+	if (nbRows == 0 || nbColumns == 0 || controlPoints.size() != size_t(nbRows) * nbColumns)
+	{
+		throw std::invalid_argument("Control points do not match the grid size");
+	}
+	if (resolutionU < 2 || resolutionV < 2)
+	{
+		throw std::invalid_argument("Resolution must be at least 2 in each direction");
+	}
+
+	ScratchVector<Vec4d> homogeneous(controlPoints.size());
+	for (size_t i = 0; i < controlPoints.size(); ++i)
+	{
+		const auto& point = controlPoints[i];
+		homogeneous[i] = Vec4d(point.w * point.x, point.w * point.y, point.w * point.z, point.w);
+	}
+
+	ScratchVector<double> bu, dbu, bv, dbv;
+	SampleBasis(nbRows - 1, resolutionU, bu, dbu);
+	SampleBasis(nbColumns - 1, resolutionV, bv, dbv);
+
+	positions.resize(size_t(resolutionU) * resolutionV);
+	normals.resize(size_t(resolutionU) * resolutionV);
+
+	ParallelFor(resolutionU, kRowGrainSize, [&](const size_t first, const size_t last) {
+		// Rows reduced at this u: one homogeneous curve in v, with its u derivative alongside
+		ScratchVector<Vec4d> curve(nbColumns);
+		ScratchVector<Vec4d> curveDu(nbColumns);
+
+		for (size_t i = first; i < last; ++i)
+		{
+			const double* weights = &bu[i * nbRows];
+			const double* weightsDu = &dbu[i * nbRows];
+			for (unsigned c = 0; c < nbColumns; ++c)
+			{
+				Vec4d point, pointDu;
+				for (unsigned r = 0; r < nbRows; ++r)
+				{
+					point += weights[r] * homogeneous[r * nbColumns + c];
+					pointDu += weightsDu[r] * homogeneous[r * nbColumns + c];
+				}
+				curve[c] = point;
+				curveDu[c] = pointDu;
+			}
+
+			for (unsigned j = 0; j < resolutionV; ++j)
+			{
+				const double* weightsV = &bv[j * nbColumns];
+				const double* weightsDv = &dbv[j * nbColumns];
+				Vec4d s, su, sv;
+				for (unsigned c = 0; c < nbColumns; ++c)
+				{
+					s += weightsV[c] * curve[c];
+					su += weightsV[c] * curveDu[c];
+					sv += weightsDv[c] * curve[c];
+				}
+
+				auto frame = ToFrame(s, su, sv);
+				auto normal = frame.du * frame.dv;
+				if (normal.Length() <= kDegenerateNormal * frame.du.Length() * frame.dv.Length() || normal.Length() == 0)
+				{
+					const auto u = double(i) / double(resolutionU - 1);
+					const auto v = double(j) / double(resolutionV - 1);
+					const auto inside = EvaluateFrame(homogeneous.data(), nbRows, nbColumns,
+						u + kNormalOffset * (1 - 2 * u), v + kNormalOffset * (1 - 2 * v));
+					normal = inside.du * inside.dv;
+				}
+				if (normal.Length() > 0)
+				{
+					normal.Normalize();
+				}
+
+				positions[i * resolutionV + j] = frame.position;
+				normals[i * resolutionV + j] = normal;
+			}
+		}
+	});
+}
@@ -0,0 +1,3 @@
+﻿
+
+#include "Box2.hpp"
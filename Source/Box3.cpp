@@ -0,0 +1,3 @@
+﻿
+
+#include "Box3.hpp"
@@ -0,0 +1,78 @@
+﻿#include "Circle.hpp"
+#include <stdexcept>
+#include "Predicates.hpp"
+
+Math::Circle::Circle (const Math::Vec2d& p1, const Math::Vec2d& p2, const Math::Vec2d& p3)
+{
+	// Circumcenter relative to p1
+	const auto b = p2 - p1;
+	const auto c = p3 - p1;
+	const auto d = 2 * (b.x * c.y - b.y * c.x);
+	if (d == 0 || Orient2D(p1, p2, p3) == 0)
+	{
+		throw std::invalid_argument("Points are collinear");
+	}
+
+	const auto b2 = Dot(b, b);
+	const auto c2 = Dot(c, c);
+	const Vec2d center((c.y * b2 - b.y * c2) / d, (b.x * c2 - c.x * b2) / d);
+
+	mCenter = p1 + center;
+	mSquaredRadius = Dot(center, center);
+}
+
+Math::Circle::Circle (const Math::Vec2d& center, const double radius)
+	: mCenter(center), mSquaredRadius(radius * radius)
+{
+}
+
+bool Math::Circle::IsPointInside (const Math::Vec2d& point) const
+{
+	const auto dx = point.x - mCenter.x;
+	const auto dy = point.y - mCenter.y;
+	return dx * dx + dy * dy < mSquaredRadius;
+}
+
+void Math::Circle::IsPointInside (const std::vector<Math::Vec2d>& points, std::vector<unsigned char>& inside) const
+{
+	inside.resize(points.size());
+
+	const auto cx = mCenter.x;
+	const auto cy = mCenter.y;
+	const auto r2 = mSquaredRadius;
+	const Vec2d* data = points.data();
+	unsigned char* result = inside.data();
+
+	for (size_t i = 0; i < points.size(); ++i)
+	{
+		const auto dx = data[i].x - cx;
+		const auto dy = data[i].y - cy;
+		result[i] = dx * dx + dy * dy < r2;
+	}
+}
+
+const Math::Vec2d& Math::Circle::Center () const
+{
+	return mCenter;
+}
+
+double Math::Circle::Radius () const
+{
+	return std::sqrt(mSquaredRadius);
+}
+
+double Math::Circle::SquaredRadius () const
+{
+	return mSquaredRadius;
+}
+
+bool Math::Circle::IsPointInCircumcircle (const Math::Vec2d& p1, const Math::Vec2d& p2, const Math::Vec2d& p3, const Math::Vec2d& point)
+{
+	const auto orientation = Orient2D(p1, p2, p3);
+	if (orientation == 0)
+	{
+		return false;
+	}
+	const auto inCircle = InCircle(p1, p2, p3, point);
+	return orientation > 0 ? inCircle > 0 : inCircle < 0;
+}
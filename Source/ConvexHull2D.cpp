@@ -0,0 +1,163 @@
+﻿#include "ConvexHull2D.hpp"
+#include "MemoryResource.hpp"
+#include "Parallel.hpp"
+#include "Predicates.hpp"
+#include <algorithm>
+#include <stdexcept>
+
+namespace
+{
+	typedef std::uint32_t Index;
+
+	const size_t kGrainSize = 1 << 15;
+
+	/**
+	 * Andrew's monotone chain over distinct points sorted by x then y.
+	 * \details Writes the hull counterclockwise from the first point and returns its size, hull
+	 *	holds count + 1 indices.
+	 */
+	size_t Chain (const std::vector<Math::Vec2d>& points, const Index* sorted, const size_t count, Index* hull)
+	{
+		if (count < 3)
+		{
+			std::copy(sorted, sorted + count, hull);
+			return count;
+		}
+
+		// Lower hull left to right, then upper hull back, both keeping left turns only
+		size_t k = 0;
+		for (size_t i = 0; i < count; ++i)
+		{
+			while (k >= 2 && Math::Orient2D(points[hull[k - 2]], points[hull[k - 1]], points[sorted[i]]) <= 0)
+			{
+				--k;
+			}
+			hull[k++] = sorted[i];
+		}
+		const size_t lower = k + 1;
+		for (size_t i = count - 1; i-- > 0;)
+		{
+			while (k >= lower && Math::Orient2D(points[hull[k - 2]], points[hull[k - 1]], points[sorted[i]]) <= 0)
+			{
+				--k;
+			}
+			hull[k++] = sorted[i];
+		}
+		return k - 1;
+	}
+
+	/**
+	 * Hull of points[order[0, count)], sorting order. Returns the size of the hull.
+	 */
+	size_t Hull (const std::vector<Math::Vec2d>& points, Index* order, size_t count, Index* hull)
+	{
+		// Akl-Toussaint: points strictly inside the polygon of the extreme points along the axes and
+		//	the diagonals are not on the hull. Extremes are in counterclockwise order, from the lowest x.
+		if (count > 0)
+		{
+			Index extremes[8];
+			std::fill(extremes, extremes + 8, order[0]);
+			for (size_t i = 1; i < count; ++i)
+			{
+				const auto& p = points[order[i]];
+				const auto index = order[i];
+				extremes[0] = p.x < points[extremes[0]].x ? index : extremes[0];
+				extremes[1] = p.x + p.y < points[extremes[1]].x + points[extremes[1]].y ? index : extremes[1];
+				extremes[2] = p.y < points[extremes[2]].y ? index : extremes[2];
+				extremes[3] = p.x - p.y > points[extremes[3]].x - points[extremes[3]].y ? index : extremes[3];
+				extremes[4] = p.x > points[extremes[4]].x ? index : extremes[4];
+				extremes[5] = p.x + p.y > points[extremes[5]].x + points[extremes[5]].y ? index : extremes[5];
+				extremes[6] = p.y > points[extremes[6]].y ? index : extremes[6];
+				extremes[7] = p.x - p.y < points[extremes[7]].x - points[extremes[7]].y ? index : extremes[7];
+			}
+
+			// An extreme point shared by neighboring directions is a single corner
+			Math::Vec2d corners[8];
+			unsigned nbCorners = 0;
+			for (unsigned i = 0; i < 8; ++i)
+			{
+				const auto& corner = points[extremes[i]];
+				if ((nbCorners == 0 || !(corners[nbCorners - 1] == corner)) && !(i == 7 && corners[0] == corner))
+				{
+					corners[nbCorners++] = corner;
+				}
+			}
+			if (nbCorners >= 3)
+			{
+				count = size_t(std::remove_if(order, order + count, [&points, &corners, nbCorners](const Index i) {
+					for (unsigned k = 0; k < nbCorners; ++k)
+					{
+						if (Math::Orient2D(corners[k], corners[(k + 1) % nbCorners], points[i]) <= 0)
+						{
+							return false;
+						}
+					}
+					return true;
+				}) - order);
+			}
+		}
+
+		std::sort(order, order + count, [&points](const Index a, const Index b) {
+			const auto& p = points[a];
+			const auto& q = points[b];
+			return p.x != q.x ? p.x < q.x : p.y != q.y ? p.y < q.y : a < b;
+		});
+		count = size_t(std::unique(order, order + count, [&points](const Index a, const Index b) {
+			return points[a] == points[b];
+		}) - order);
+		return Chain(points, order, count, hull);
+	}
+}
+
+Math::ConvexHull2D::ConvexHull2D ()
+{
+}
+
+Math::ConvexHull2D::ConvexHull2D (const std::vector<Vec2d>& points)
+{
+	Build(points);
+}
+
+void Math::ConvexHull2D::Build (const std::vector<Vec2d>& points)
+{
+	if (points.size() >= 0xFFFFFFFF)
+	{
+		throw std::invalid_argument("Too many points for 32 bits indices");
+	}
+
+	// Hull of each chunk in its own part of mChains, one index longer than the chunk
+	const size_t count = points.size();
+	const size_t chunks = ParallelChunks(count, kGrainSize);
+	mOrder.resize(count);
+	mChains.resize(count + chunks);
+	ScratchVector<size_t> starts(chunks);
+	ScratchVector<size_t> sizes(chunks);
+	ParallelForChunks(count, kGrainSize, [&](const size_t chunk, const size_t first, const size_t last) {
+		for (size_t i = first; i < last; ++i)
+		{
+			mOrder[i] = Index(i);
+		}
+		starts[chunk] = first + chunk;
+		sizes[chunk] = Hull(points, mOrder.data() + first, last - first, mChains.data() + first + chunk);
+	});
+	if (chunks == 1)
+	{
+		mVertices.assign(mChains.begin(), mChains.begin() + sizes[0]);
+		return;
+	}
+
+	// Only the vertices of the chunk hulls can be on the hull
+	size_t candidates = 0;
+	for (size_t chunk = 0; chunk < chunks; ++chunk)
+	{
+		std::copy(mChains.begin() + starts[chunk], mChains.begin() + starts[chunk] + sizes[chunk], mOrder.begin() + candidates);
+		candidates += sizes[chunk];
+	}
+	const size_t size = Hull(points, mOrder.data(), candidates, mChains.data());
+	mVertices.assign(mChains.begin(), mChains.begin() + size);
+}
+
+const std::vector<std::uint32_t>& Math::ConvexHull2D::Vertices () const
+{
+	return mVertices;
+}
@@ -0,0 +1,434 @@
+﻿#include "ConvexHull3D.hpp"
+#include "Parallel.hpp"
+#include "Predicates.hpp"
+#include "SpatialSort.hpp"
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+namespace
+{
+	typedef std::uint32_t Index;
+
+	const Index kNone = 0xFFFFFFFF;
+	const size_t kGrainSize = 1 << 15;
+
+	enum State : unsigned char
+	{
+		kAlive,
+		kVisible,
+		kHidden,
+		kRemoved
+	};
+
+	bool Collinear (const Math::Vec3d& a, const Math::Vec3d& b, const Math::Vec3d& c)
+	{
+		// The cross product is null exactly when its three projections are
+		return Math::Orient2D(Math::Vec2d(a.x, a.y), Math::Vec2d(b.x, b.y), Math::Vec2d(c.x, c.y)) == 0
+			&& Math::Orient2D(Math::Vec2d(a.y, a.z), Math::Vec2d(b.y, b.z), Math::Vec2d(c.y, c.z)) == 0
+			&& Math::Orient2D(Math::Vec2d(a.z, a.x), Math::Vec2d(b.z, b.x), Math::Vec2d(c.z, c.x)) == 0;
+	}
+
+	double SquaredDistance (const Math::Vec3d& a, const Math::Vec3d& b)
+	{
+		const auto d = b - a;
+		return d.x * d.x + d.y * d.y + d.z * d.z;
+	}
+
+	double SquaredCross (const Math::Vec3d& a, const Math::Vec3d& b, const Math::Vec3d& c)
+	{
+		const auto u = b - a;
+		const auto v = c - a;
+		const double x = u.y * v.z - u.z * v.y;
+		const double y = u.z * v.x - u.x * v.z;
+		const double z = u.x * v.y - u.y * v.x;
+		return x * x + y * y + z * z;
+	}
+
+	/**
+	 * Increasing indices used by triangles
+	 */
+	void VerticesOf (const std::vector<Index>& triangles, std::vector<Index>& vertices)
+	{
+		vertices.assign(triangles.begin(), triangles.end());
+		std::sort(vertices.begin(), vertices.end());
+		vertices.erase(std::unique(vertices.begin(), vertices.end()), vertices.end());
+	}
+}
+
+Math::ConvexHull3D::ConvexHull3D ()
+{
+}
+
+Math::ConvexHull3D::ConvexHull3D (const std::vector<Vec3d>& points)
+{
+	Build(points);
+}
+
+void Math::ConvexHull3D::Build (const std::vector<Vec3d>& points)
+{
+	if (points.size() >= 0xFFFFFFFF)
+	{
+		throw std::invalid_argument("Too many points for 32 bits indices");
+	}
+
+	// Hull of each chunk, then of their vertices. A coplanar chunk keeps all its points.
+	const size_t chunks = ParallelChunks(points.size(), kGrainSize);
+	mWorkspaces.resize(std::max(mWorkspaces.size(), chunks));
+	ParallelForChunks(points.size(), kGrainSize, [&](const size_t chunk, const size_t first, const size_t last) {
+		auto& workspace = mWorkspaces[chunk];
+		workspace.ids.resize(last - first);
+		for (size_t i = first; i < last; ++i)
+		{
+			workspace.ids[i - first] = Index(i);
+		}
+		if (workspace.Build(points) && chunks > 1)
+		{
+			VerticesOf(workspace.triangles, workspace.ids);
+		}
+	});
+
+	auto& workspace = mWorkspaces[0];
+	if (chunks > 1)
+	{
+		for (size_t chunk = 1; chunk < chunks; ++chunk)
+		{
+			const auto& ids = mWorkspaces[chunk].ids;
+			workspace.ids.insert(workspace.ids.end(), ids.begin(), ids.end());
+		}
+		workspace.Build(points);
+	}
+	mTriangles.assign(workspace.triangles.begin(), workspace.triangles.end());
+	VerticesOf(mTriangles, mVertices);
+}
+
+size_t Math::ConvexHull3D::NbTriangles () const
+{
+	return mTriangles.size() / 3;
+}
+
+const std::vector<std::uint32_t>& Math::ConvexHull3D::Triangles () const
+{
+	return mTriangles;
+}
+
+const std::vector<std::uint32_t>& Math::ConvexHull3D::Vertices () const
+{
+	return mVertices;
+}
+
+bool Math::ConvexHull3D::Workspace::Build (const std::vector<Vec3d>& points)
+{
+	triangles.clear();
+	faces.clear();
+	free.clear();
+	pending.clear();
+	positions.resize(ids.size());
+	for (size_t i = 0; i < ids.size(); ++i)
+	{
+		positions[i] = points[ids[i]];
+	}
+	SpatialOrder(positions, kMorton, order);
+	Permute(positions, order);
+	for (size_t i = 0; i < ids.size(); ++i)
+	{
+		order[i] = ids[order[i]];
+	}
+	ids.swap(order);
+	next.resize(ids.size());
+	horizon.resize(ids.size());
+	if (!Initialize())
+	{
+		return false;
+	}
+
+	// A face can be listed again after its slot was reused, or be gone
+	while (!pending.empty())
+	{
+		const auto face = pending.back();
+		pending.pop_back();
+		if (faces[face].state == kAlive && faces[face].outside != kNone)
+		{
+			AddPoint(face);
+		}
+	}
+
+	for (const auto& face : faces)
+	{
+		if (face.state == kAlive)
+		{
+			triangles.push_back(ids[face.vertices[0]]);
+			triangles.push_back(ids[face.vertices[1]]);
+			triangles.push_back(ids[face.vertices[2]]);
+		}
+	}
+	return true;
+}
+
+bool Math::ConvexHull3D::Workspace::Initialize ()
+{
+	const auto count = Index(positions.size());
+	if (count < 4)
+	{
+		return false;
+	}
+
+	// Farthest pair among the extreme points along the axes
+	Index extremes[6] = { 0, 0, 0, 0, 0, 0 };
+	for (Index i = 1; i < count; ++i)
+	{
+		const auto& p = positions[i];
+		extremes[0] = p.x < positions[extremes[0]].x ? i : extremes[0];
+		extremes[1] = p.x > positions[extremes[1]].x ? i : extremes[1];
+		extremes[2] = p.y < positions[extremes[2]].y ? i : extremes[2];
+		extremes[3] = p.y > positions[extremes[3]].y ? i : extremes[3];
+		extremes[4] = p.z < positions[extremes[4]].z ? i : extremes[4];
+		extremes[5] = p.z > positions[extremes[5]].z ? i : extremes[5];
+	}
+	Index a = 0, b = 0;
+	double farthest = 0;
+	for (unsigned i = 0; i < 6; ++i)
+	{
+		for (unsigned j = i + 1; j < 6; ++j)
+		{
+			const double distance = SquaredDistance(positions[extremes[i]], positions[extremes[j]]);
+			if (distance > farthest)
+			{
+				farthest = distance;
+				a = extremes[i];
+				b = extremes[j];
+			}
+		}
+	}
+	if (farthest == 0)
+	{
+		return false;
+	}
+
+	// Farthest point from the line, checked exactly
+	Index c = a;
+	farthest = 0;
+	for (Index i = 0; i < count; ++i)
+	{
+		const double distance = SquaredCross(positions[a], positions[b], positions[i]);
+		if (distance > farthest)
+		{
+			farthest = distance;
+			c = i;
+		}
+	}
+	if (Collinear(positions[a], positions[b], positions[c]))
+	{
+		c = 0;
+		while (c < count && Collinear(positions[a], positions[b], positions[c]))
+		{
+			++c;
+		}
+		if (c == count)
+		{
+			return false;
+		}
+	}
+
+	// Farthest point from the plane
+	Index d = a;
+	farthest = 0;
+	for (Index i = 0; i < count; ++i)
+	{
+		const double distance = std::abs(Orient3D(positions[a], positions[b], positions[c], positions[i]));
+		if (distance > farthest)
+		{
+			farthest = distance;
+			d = i;
+		}
+	}
+	if (farthest == 0)
+	{
+		return false;
+	}
+
+	// Tetrahedron with d below abc, every face seeing the other vertex below
+	if (Orient3D(positions[a], positions[b], positions[c], positions[d]) < 0)
+	{
+		std::swap(b, c);
+	}
+	AddFace(a, b, c);
+	AddFace(a, c, d);
+	AddFace(a, d, b);
+	AddFace(b, d, c);
+	for (Index f = 0; f < 4; ++f)
+	{
+		for (unsigned k = 0; k < 3; ++k)
+		{
+			const auto from = faces[f].vertices[k];
+			const auto to = faces[f].vertices[(k + 1) % 3];
+			for (Index g = 0; g < 4; ++g)
+			{
+				for (unsigned j = 0; j < 3; ++j)
+				{
+					if (faces[g].vertices[j] == to && faces[g].vertices[(j + 1) % 3] == from)
+					{
+						faces[f].neighbors[k] = g;
+					}
+				}
+			}
+		}
+	}
+
+	created.assign({ 0, 1, 2, 3 });
+	for (Index i = 0; i < count; ++i)
+	{
+		if (i != a && i != b && i != c && i != d)
+		{
+			Assign(i);
+		}
+	}
+	return true;
+}
+
+void Math::ConvexHull3D::Workspace::AddPoint (const Index face)
+{
+	const auto eye = faces[face].furthest;
+	const auto& p = positions[eye];
+
+	// Faces seeing the eye, connected to the first one
+	visible.clear();
+	hidden.clear();
+	stack.clear();
+	faces[face].state = kVisible;
+	visible.push_back(face);
+	stack.push_back(face);
+	while (!stack.empty())
+	{
+		const auto t = stack.back();
+		stack.pop_back();
+		for (unsigned k = 0; k < 3; ++k)
+		{
+			const auto n = faces[t].neighbors[k];
+			if (faces[n].state == kAlive)
+			{
+				const auto& v = faces[n].vertices;
+				if (Orient3D(positions[v[0]], positions[v[1]], positions[v[2]], p) < 0)
+				{
+					faces[n].state = kVisible;
+					visible.push_back(n);
+					stack.push_back(n);
+				}
+				else
+				{
+					faces[n].state = kHidden;
+					hidden.push_back(n);
+				}
+			}
+		}
+	}
+
+	// Horizon edges and outside points are copied out before the slots of the visible faces are reused
+	edges.clear();
+	orphans.clear();
+	for (const auto t : visible)
+	{
+		for (unsigned k = 0; k < 3; ++k)
+		{
+			const auto n = faces[t].neighbors[k];
+			if (faces[n].state == kHidden)
+			{
+				const auto& outer = faces[n].neighbors;
+				edges.push_back(faces[t].vertices[k]);
+				edges.push_back(faces[t].vertices[(k + 1) % 3]);
+				edges.push_back(n);
+				edges.push_back(outer[0] == t ? 0 : outer[1] == t ? 1 : 2);
+			}
+		}
+		for (auto i = faces[t].outside; i != kNone; i = next[i])
+		{
+			if (i != eye)
+			{
+				orphans.push_back(i);
+			}
+		}
+		faces[t].state = kRemoved;
+		free.push_back(t);
+	}
+
+	// One new face per horizon edge, linked to the hidden face across it, then to each other
+	created.clear();
+	for (size_t e = 0; e < edges.size(); e += 4)
+	{
+		const auto from = edges[e];
+		const auto n = edges[e + 2];
+		const auto f = AddFace(from, edges[e + 1], eye);
+		faces[f].neighbors[0] = n;
+		faces[n].neighbors[edges[e + 3]] = f;
+		horizon[from] = f;
+		created.push_back(f);
+	}
+	for (const auto f : created)
+	{
+		const auto g = horizon[faces[f].vertices[1]];
+		faces[f].neighbors[1] = g;
+		faces[g].neighbors[2] = f;
+	}
+
+	// Points outside the removed faces are outside a new one, or inside the hull
+	for (const auto i : orphans)
+	{
+		Assign(i);
+	}
+	for (const auto t : hidden)
+	{
+		faces[t].state = kAlive;
+	}
+}
+
+std::uint32_t Math::ConvexHull3D::Workspace::AddFace (const Index a, const Index b, const Index c)
+{
+	Face face;
+	face.vertices[0] = a;
+	face.vertices[1] = b;
+	face.vertices[2] = c;
+	face.neighbors[0] = face.neighbors[1] = face.neighbors[2] = kNone;
+	face.outside = kNone;
+	face.furthest = kNone;
+	face.distance = 0;
+	face.state = kAlive;
+	if (free.empty())
+	{
+		faces.push_back(face);
+		return Index(faces.size() - 1);
+	}
+	const auto slot = free.back();
+	free.pop_back();
+	faces[slot] = face;
+	return slot;
+}
+
+void Math::ConvexHull3D::Workspace::AddOutside (const Index face, const Index point, const double distance)
+{
+	if (faces[face].outside == kNone)
+	{
+		pending.push_back(face);
+	}
+	next[point] = faces[face].outside;
+	faces[face].outside = point;
+	if (distance > faces[face].distance)
+	{
+		faces[face].distance = distance;
+		faces[face].furthest = point;
+	}
+}
+
+void Math::ConvexHull3D::Workspace::Assign (const Index point)
+{
+	const auto& p = positions[point];
+	for (const auto f : created)
+	{
+		const auto& v = faces[f].vertices;
+		const double orientation = Orient3D(positions[v[0]], positions[v[1]], positions[v[2]], p);
+		if (orientation < 0)
+		{
+			AddOutside(f, point, -orientation);
+			return;
+		}
+	}
+}
@@ -0,0 +1,374 @@
+﻿#include "DelaunayTriangulation.hpp"
+#include "MemoryResource.hpp"
+#include "Predicates.hpp"
+#include "SpatialSort.hpp"
+#include <algorithm>
+#include <stdexcept>
+
+namespace
+{
+	typedef std::uint32_t Index;
+
+	Index Next (const Index e)
+	{
+		return e % 3 == 2 ? e - 2 : e + 1;
+	}
+
+	/**
+	 * Mesh under construction, closed by ghost triangles holding the vertex at infinity
+	 */
+	class Builder
+	{
+	public:
+		explicit Builder(const std::vector<Math::Vec2d>& points)
+			: mPoints(points), mGhost(Index(points.size())), mStart(points.size() + 1, 0), mLast(0)
+		{
+			mTriangles.reserve(6 * points.size() + 6);
+			mHalfedges.reserve(6 * points.size() + 6);
+			mMarks.reserve(2 * points.size() + 2);
+		}
+
+		bool Initialize (const std::vector<Index>& order)
+		{
+			const auto a = order[0];
+			size_t i = 1;
+			while (i < order.size() && mPoints[order[i]] == mPoints[a])
+			{
+				++i;
+			}
+			if (i == order.size())
+			{
+				return false;
+			}
+			auto b = order[i];
+			while (i < order.size() && Math::Orient2D(mPoints[a], mPoints[b], mPoints[order[i]]) == 0)
+			{
+				++i;
+			}
+			if (i == order.size())
+			{
+				return false;
+			}
+			auto c = order[i];
+			if (Math::Orient2D(mPoints[a], mPoints[b], mPoints[c]) < 0)
+			{
+				std::swap(b, c);
+			}
+
+			// One triangle and the three ghosts across its edges
+			AddTriangle(a, b, c);
+			AddTriangle(b, a, mGhost);
+			AddTriangle(c, b, mGhost);
+			AddTriangle(a, c, mGhost);
+			Link(0, 3);
+			Link(1, 6);
+			Link(2, 9);
+			Link(4, 11);
+			Link(7, 5);
+			Link(10, 8);
+			return true;
+		}
+
+		void Insert (const Index p)
+		{
+			const auto seed = Locate(p);
+			if (seed == Math::DelaunayTriangulation::kNone)
+			{
+				return;
+			}
+
+			// Cavity: the triangles whose circumcircle holds p, connected to the seed
+			mCavity.clear();
+			mVisited.clear();
+			mStack.clear();
+			mStack.push_back(seed);
+			mVisited.push_back(seed);
+			mMarks[seed] = kInCavity;
+			while (!mStack.empty())
+			{
+				const auto t = mStack.back();
+				mStack.pop_back();
+				mCavity.push_back(t);
+				for (Index k = 0; k < 3; ++k)
+				{
+					const auto n = mHalfedges[3 * t + k] / 3;
+					if (mMarks[n] == kUnvisited)
+					{
+						mVisited.push_back(n);
+						mMarks[n] = Conflicts(n, p) ? kInCavity : kOutside;
+						if (mMarks[n] == kInCavity)
+						{
+							mStack.push_back(n);
+						}
+					}
+				}
+			}
+
+			// Edges of the cavity boundary, a star around p: one new triangle each, in the freed slots first.
+			// They are copied out before the slots are overwritten.
+			mBoundary.clear();
+			for (const auto t : mCavity)
+			{
+				for (Index k = 0; k < 3; ++k)
+				{
+					const auto e = 3 * t + k;
+					if (mMarks[mHalfedges[e] / 3] != kInCavity)
+					{
+						mBoundary.push_back(mTriangles[e]);
+						mBoundary.push_back(mTriangles[Next(e)]);
+						mBoundary.push_back(mHalfedges[e]);
+					}
+				}
+			}
+
+			mCreated.clear();
+			for (size_t i = 0; i < mBoundary.size() / 3; ++i)
+			{
+				const auto from = mBoundary[3 * i];
+				const auto to = mBoundary[3 * i + 1];
+				const auto outer = mBoundary[3 * i + 2];
+				Index t;
+				if (i < mCavity.size())
+				{
+					t = mCavity[i];
+					mTriangles[3 * t] = from;
+					mTriangles[3 * t + 1] = to;
+					mTriangles[3 * t + 2] = p;
+				}
+				else
+				{
+					t = AddTriangle(from, to, p);
+				}
+				Link(3 * t, outer);
+				mStart[from] = t;
+				mCreated.push_back(t);
+			}
+			for (const auto t : mCreated)
+			{
+				Link(3 * t + 1, 3 * mStart[mTriangles[3 * t + 1]] + 2);
+			}
+
+			for (const auto t : mVisited)
+			{
+				mMarks[t] = kUnvisited;
+			}
+			mLast = mCreated.back();
+		}
+
+		void Finish (std::vector<Index>& triangles, std::vector<Index>& halfedges)
+		{
+			// Drop the ghosts, compacting in place since a triangle never moves to a higher slot
+			const Index nbTriangles = Index(mTriangles.size() / 3);
+			std::vector<Index> remap(nbTriangles, Math::DelaunayTriangulation::kNone);
+			Index count = 0;
+			for (Index t = 0; t < nbTriangles; ++t)
+			{
+				if (!IsGhost(t))
+				{
+					remap[t] = count++;
+				}
+			}
+
+			for (Index t = 0; t < nbTriangles; ++t)
+			{
+				if (remap[t] == Math::DelaunayTriangulation::kNone)
+				{
+					continue;
+				}
+				for (Index k = 0; k < 3; ++k)
+				{
+					const auto twin = mHalfedges[3 * t + k];
+					const auto neighbour = remap[twin / 3];
+					mTriangles[3 * remap[t] + k] = mTriangles[3 * t + k];
+					mHalfedges[3 * remap[t] + k] = neighbour == Math::DelaunayTriangulation::kNone
+						? Math::DelaunayTriangulation::kNone : 3 * neighbour + twin % 3;
+				}
+			}
+
+			mTriangles.resize(3 * count);
+			mHalfedges.resize(3 * count);
+			mTriangles.shrink_to_fit();
+			mHalfedges.shrink_to_fit();
+			triangles.swap(mTriangles);
+			halfedges.swap(mHalfedges);
+		}
+
+	private:
+		enum Mark : unsigned char
+		{
+			kUnvisited,
+			kInCavity,
+			kOutside
+		};
+
+		Index AddTriangle (const Index a, const Index b, const Index c)
+		{
+			const auto t = Index(mTriangles.size() / 3);
+			mTriangles.push_back(a);
+			mTriangles.push_back(b);
+			mTriangles.push_back(c);
+			mHalfedges.resize(mTriangles.size(), Math::DelaunayTriangulation::kNone);
+			mMarks.push_back(kUnvisited);
+			return t;
+		}
+
+		void Link (const Index e, const Index twin)
+		{
+			mHalfedges[e] = twin;
+			mHalfedges[twin] = e;
+		}
+
+		bool IsGhost (const Index t) const
+		{
+			return mTriangles[3 * t] == mGhost || mTriangles[3 * t + 1] == mGhost || mTriangles[3 * t + 2] == mGhost;
+		}
+
+		/**
+		 * Halfedge of a ghost triangle between its two finite vertices
+		 */
+		Index FiniteEdge (const Index t) const
+		{
+			if (mTriangles[3 * t + 2] == mGhost)
+			{
+				return 3 * t;
+			}
+			return mTriangles[3 * t] == mGhost ? 3 * t + 1 : 3 * t + 2;
+		}
+
+		/**
+		 * p on the line through a and b, strictly between them
+		 */
+		bool IsBetween (const Math::Vec2d& a, const Math::Vec2d& b, const Math::Vec2d& p) const
+		{
+			if (a.x != b.x)
+			{
+				return (p.x > a.x && p.x < b.x) || (p.x < a.x && p.x > b.x);
+			}
+			return (p.y > a.y && p.y < b.y) || (p.y < a.y && p.y > b.y);
+		}
+
+		/**
+		 * The circumcircle of a ghost triangle is the open half plane beyond its finite edge plus that open edge
+		 */
+		bool Conflicts (const Index t, const Index p) const
+		{
+			const auto& point = mPoints[p];
+			if (!IsGhost(t))
+			{
+				return Math::InCircle(mPoints[mTriangles[3 * t]], mPoints[mTriangles[3 * t + 1]], mPoints[mTriangles[3 * t + 2]], point) > 0;
+			}
+
+			const auto e = FiniteEdge(t);
+			const auto& a = mPoints[mTriangles[e]];
+			const auto& b = mPoints[mTriangles[Next(e)]];
+			const auto orientation = Math::Orient2D(a, b, point);
+			return orientation > 0 || (orientation == 0 && IsBetween(a, b, point));
+		}
+
+		/**
+		 * Visibility walk from the last inserted triangle: kNone when p is already a vertex
+		 */
+		Index Locate (const Index p) const
+		{
+			const auto& point = mPoints[p];
+			auto t = mLast;
+			auto entry = Math::DelaunayTriangulation::kNone;
+			for (;;)
+			{
+				if (IsGhost(t))
+				{
+					if (Conflicts(t, p))
+					{
+						return t;
+					}
+					entry = mHalfedges[FiniteEdge(t)];
+					t = entry / 3;
+					continue;
+				}
+
+				bool moved = false;
+				for (Index k = 0; k < 3 && !moved; ++k)
+				{
+					const auto e = 3 * t + k;
+					if (e == entry)
+					{
+						continue;
+					}
+					if (Math::Orient2D(mPoints[mTriangles[e]], mPoints[mTriangles[Next(e)]], point) < 0)
+					{
+						entry = mHalfedges[e];
+						t = entry / 3;
+						moved = true;
+					}
+				}
+				if (!moved)
+				{
+					for (Index k = 0; k < 3; ++k)
+					{
+						if (mPoints[mTriangles[3 * t + k]] == point)
+						{
+							return Math::DelaunayTriangulation::kNone;
+						}
+					}
+					return t;
+				}
+			}
+		}
+
+		const std::vector<Math::Vec2d>& mPoints;
+		const Index mGhost;
+		std::vector<Index> mTriangles;
+		std::vector<Index> mHalfedges;
+		std::vector<unsigned char> mMarks;
+		Math::ScratchVector<Index> mStart; /// New triangle starting at a vertex of the cavity boundary
+		Math::ScratchVector<Index> mCavity;
+		Math::ScratchVector<Index> mVisited;
+		Math::ScratchVector<Index> mStack;
+		Math::ScratchVector<Index> mBoundary; /// From, to and outer halfedge of each edge
+		Math::ScratchVector<Index> mCreated;
+		Index mLast;
+	};
+}
+
+const std::uint32_t Math::DelaunayTriangulation::kNone;
+
+Math::DelaunayTriangulation::DelaunayTriangulation (const std::vector<Vec2d>& points)
+{
+	// About 2n triangles with the ghosts, 6n halfedges
+	if (points.size() > (kNone - 12) / 6)
+	{
+		throw std::invalid_argument("Too many points for 32 bits indices");
+	}
+	if (points.size() < 3)
+	{
+		return;
+	}
+
+	std::vector<std::uint32_t> order;
+	Math::SpatialOrder(points, Math::kHilbert, order);
+	Builder builder(points);
+	if (!builder.Initialize(order))
+	{
+		return;
+	}
+	for (const auto p : order)
+	{
+		builder.Insert(p);
+	}
+	builder.Finish(mTriangles, mHalfedges);
+}
+
+size_t Math::DelaunayTriangulation::NbTriangles () const
+{
+	return mTriangles.size() / 3;
+}
+
+const std::vector<std::uint32_t>& Math::DelaunayTriangulation::Triangles () const
+{
+	return mTriangles;
+}
+
+const std::vector<std::uint32_t>& Math::DelaunayTriangulation::Halfedges () const
+{
+	return mHalfedges;
+}
@@ -0,0 +1,145 @@
+﻿#include "MemoryResource.hpp"
+#include <algorithm>
+#include <new>
+
+namespace
+{
+	/**
+	 * operator new only guarantees max_align_t, larger alignments over-allocate
+	 *	and keep the original pointer just before the aligned one.
+	 */
+	class NewDelete : public Math::MemoryResource
+	{
+	public:
+		void* Allocate(const size_t bytes, const size_t alignment) override
+		{
+			if (alignment <= alignof(std::max_align_t))
+			{
+				return ::operator new(bytes);
+			}
+
+			char* raw = static_cast<char*>(::operator new(bytes + alignment + sizeof(void*)));
+			const auto address = reinterpret_cast<size_t>(raw + sizeof(void*));
+			char* aligned = raw + sizeof(void*) + (alignment - address % alignment) % alignment;
+			reinterpret_cast<void**>(aligned)[-1] = raw;
+			return aligned;
+		}
+
+		void Deallocate(void* pointer, size_t, const size_t alignment) override
+		{
+			if (alignment <= alignof(std::max_align_t))
+			{
+				::operator delete(pointer);
+				return;
+			}
+			::operator delete(static_cast<void**>(pointer)[-1]);
+		}
+	};
+
+	thread_local Math::MemoryResource* scratchResource = nullptr;
+}
+
+Math::MemoryResource::~MemoryResource ()
+{
+}
+
+Math::MemoryResource* Math::NewDeleteResource ()
+{
+	static NewDelete resource;
+	return &resource;
+}
+
+Math::MemoryResource* Math::GetScratchResource ()
+{
+	return scratchResource ? scratchResource : NewDeleteResource();
+}
+
+Math::MemoryResource* Math::SetScratchResource (MemoryResource* resource)
+{
+	const auto previous = GetScratchResource();
+	scratchResource = resource;
+	return previous;
+}
+
+Math::ScopedScratchResource::ScopedScratchResource (MemoryResource* resource)
+	: mPrevious(SetScratchResource(resource))
+{
+}
+
+Math::ScopedScratchResource::~ScopedScratchResource ()
+{
+	SetScratchResource(mPrevious);
+}
+
+Math::MonotonicArena::MonotonicArena (const size_t blockSize, MemoryResource* upstream)
+	: mBlockSize(blockSize), mUpstream(upstream), mCurrent(0), mOffset(0)
+{
+}
+
+Math::MonotonicArena::~MonotonicArena ()
+{
+	Release();
+}
+
+void* Math::MonotonicArena::Allocate (const size_t bytes, const size_t alignment)
+{
+	std::lock_guard<std::mutex> lock(mMutex);
+
+	// Try the current block, then the blocks kept by Reset, then ask upstream for a new one
+	for (; mCurrent < mBlocks.size(); ++mCurrent, mOffset = 0)
+	{
+		const auto& block = mBlocks[mCurrent];
+		const auto address = reinterpret_cast<size_t>(block.data) + mOffset;
+		const auto start = mOffset + (alignment - address % alignment) % alignment;
+		if (start + bytes <= block.size)
+		{
+			mOffset = start + bytes;
+			return block.data + start;
+		}
+	}
+
+	Block block;
+	block.size = std::max(mBlockSize, bytes + alignment);
+	block.data = static_cast<char*>(mUpstream->Allocate(block.size, alignof(std::max_align_t)));
+	mBlocks.push_back(block);
+	mCurrent = mBlocks.size() - 1;
+
+	const auto address = reinterpret_cast<size_t>(block.data);
+	const auto start = (alignment - address % alignment) % alignment;
+	mOffset = start + bytes;
+	return block.data + start;
+}
+
+void Math::MonotonicArena::Deallocate (void*, size_t, size_t)
+{
+}
+
+void Math::MonotonicArena::Reset ()
+{
+	std::lock_guard<std::mutex> lock(mMutex);
+	mCurrent = 0;
+	mOffset = 0;
+}
+
+void Math::MonotonicArena::Release ()
+{
+	std::lock_guard<std::mutex> lock(mMutex);
+	for (const auto& block : mBlocks)
+	{
+		mUpstream->Deallocate(block.data, block.size, alignof(std::max_align_t));
+	}
+	mBlocks.clear();
+	mCurrent = 0;
+	mOffset = 0;
+}
+
+size_t Math::MonotonicArena::Capacity () const
+{
+	std::lock_guard<std::mutex> lock(mMutex);
+	size_t capacity = 0;
+	for (const auto& block : mBlocks)
+	{
+		capacity += block.size;
+	}
+	return capacity;
+}
@@ -0,0 +1,215 @@
+﻿#include "Parallel.hpp"
+#include "MemoryResource.hpp"
+#include <atomic>
+#include <condition_variable>
+#include <exception>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace
+{
+	/**
+	 * Parallel call, on the stack of the calling thread until all its chunks are done
+	 */
+	struct Job
+	{
+		void (*task)(void*, size_t);
+		void* context;
+		Math::MemoryResource* resource; /// Scratch resource of the calling thread
+		size_t chunks;
+		size_t next; /// First chunk not taken yet
+		size_t done;
+		size_t failed; /// Lowest chunk that threw, chunks when none did
+		std::exception_ptr error;
+		Job* following; /// Next job with chunks left
+	};
+
+	/**
+	 * Worker threads started by the first parallel call and joined at exit.
+	 * \details Jobs with chunks left wait in a list. Workers take chunks from the oldest one, the
+	 *	calling thread takes chunks from its own job then waits for the ones taken by workers. A chunk
+	 *	making a parallel call runs it the same way, so nested calls never wait for a free worker.
+	 */
+	class Pool
+	{
+	public:
+		Pool();
+		~Pool();
+
+		void Run(Job& job);
+
+	private:
+		void Start();
+		void Work();
+		void Execute(Job& job, std::unique_lock<std::mutex>& lock); /// Take the next chunk of job and run it unlocked
+
+		std::mutex mMutex;
+		std::condition_variable mWork;
+		std::condition_variable mDone;
+		Job* mJobs;
+		bool mStop;
+
+		std::mutex mStartMutex;
+		std::atomic<bool> mStarted;
+		std::vector<std::thread> mWorkers;
+	};
+
+	Pool::Pool ()
+		: mJobs(nullptr), mStop(false), mStarted(false)
+	{
+	}
+
+	Pool::~Pool ()
+	{
+		{
+			std::lock_guard<std::mutex> lock(mMutex);
+			mStop = true;
+		}
+		mWork.notify_all();
+		for (auto& worker : mWorkers)
+		{
+			worker.join();
+		}
+	}
+
+	void Pool::Run (Job& job)
+	{
+		if (!mStarted.load(std::memory_order_acquire))
+		{
+			Start();
+		}
+
+		std::unique_lock<std::mutex> lock(mMutex);
+		Job** last = &mJobs;
+		while (*last)
+		{
+			last = &(*last)->following;
+		}
+		*last = &job;
+		mWork.notify_all();
+
+		while (job.next < job.chunks)
+		{
+			Execute(job, lock);
+		}
+		mDone.wait(lock, [&job]() { return job.done == job.chunks; });
+	}
+
+	void Pool::Start ()
+	{
+		std::lock_guard<std::mutex> guard(mStartMutex);
+		if (mStarted.load(std::memory_order_relaxed))
+		{
+			return;
+		}
+
+		// A worker failing to start stops the ones already running, the next call tries again
+		try
+		{
+			mWorkers.reserve(Math::ParallelThreads() - 1);
+			for (size_t i = 1; i < Math::ParallelThreads(); ++i)
+			{
+				mWorkers.push_back(std::thread(&Pool::Work, this));
+			}
+		}
+		catch (...)
+		{
+			{
+				std::lock_guard<std::mutex> lock(mMutex);
+				mStop = true;
+			}
+			mWork.notify_all();
+			for (auto& worker : mWorkers)
+			{
+				worker.join();
+			}
+			mWorkers.clear();
+			mStop = false;
+			throw;
+		}
+		mStarted.store(true, std::memory_order_release);
+	}
+
+	void Pool::Work ()
+	{
+		std::unique_lock<std::mutex> lock(mMutex);
+		while (true)
+		{
+			mWork.wait(lock, [this]() { return mStop || mJobs; });
+			if (mStop)
+			{
+				return;
+			}
+			Execute(*mJobs, lock);
+		}
+	}
+
+	void Pool::Execute (Job& job, std::unique_lock<std::mutex>& lock)
+	{
+		const size_t chunk = job.next++;
+		if (job.next == job.chunks)
+		{
+			Job** link = &mJobs;
+			while (*link != &job)
+			{
+				link = &(*link)->following;
+			}
+			*link = job.following;
+		}
+
+		lock.unlock();
+		std::exception_ptr error;
+		try
+		{
+			Math::ScopedScratchResource scratch(job.resource);
+			job.task(job.context, chunk);
+		}
+		catch (...)
+		{
+			error = std::current_exception();
+		}
+		lock.lock();
+
+		if (error && chunk < job.failed)
+		{
+			job.failed = chunk;
+			job.error = error;
+		}
+		if (++job.done == job.chunks)
+		{
+			mDone.notify_all();
+		}
+	}
+
+	Pool& GetPool ()
+	{
+		static Pool pool;
+		return pool;
+	}
+}
+
+size_t Math::ParallelThreads ()
+{
+	static const size_t threads = std::max(1u, std::thread::hardware_concurrency());
+	return threads;
+}
+
+void Math::ParallelDetail::Run (const size_t chunks, void (*task)(void*, size_t), void* context)
+{
+	Job job;
+	job.task = task;
+	job.context = context;
+	job.resource = GetScratchResource();
+	job.chunks = chunks;
+	job.next = 0;
+	job.done = 0;
+	job.failed = chunks;
+	job.following = nullptr;
+	GetPool().Run(job);
+
+	if (job.error)
+	{
+		std::rethrow_exception(job.error);
+	}
+}
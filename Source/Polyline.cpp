@@ -0,0 +1,3 @@
+﻿
+
+#include "Polyline.hpp"
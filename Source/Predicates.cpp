@@ -0,0 +1,408 @@
+﻿#include "Predicates.hpp"
+#include <cmath>
+#include "MemoryResource.hpp"
+
+namespace
+{
+	typedef Math::ScratchVector<double> Expansion;
+
+	// Shewchuk's epsilon is half an ulp of 1, the relative error of one rounding
+	const double kEpsilon = 1.1102230246251565e-16;
+	const double kSplitter = 134217729.0; // 2^27 + 1
+	const double kOrient2DBound = (3.0 + 16.0 * kEpsilon) * kEpsilon;
+	const double kOrient3DBound = (7.0 + 56.0 * kEpsilon) * kEpsilon;
+	const double kInCircleBound = (10.0 + 96.0 * kEpsilon) * kEpsilon;
+	const double kInSphereBound = (16.0 + 224.0 * kEpsilon) * kEpsilon;
+
+	/*
+	 * Error free transformations, x is the rounded result and y its rounding error.
+	 * They assume round to nearest double arithmetic without extended precision or fused multiply-add.
+	 */
+	void FastTwoSum (const double a, const double b, double& x, double& y)
+	{
+		x = a + b;
+		y = b - (x - a);
+	}
+
+	void TwoSum (const double a, const double b, double& x, double& y)
+	{
+		x = a + b;
+		const double bVirtual = x - a;
+		const double aVirtual = x - bVirtual;
+		y = (a - aVirtual) + (b - bVirtual);
+	}
+
+	void TwoDiff (const double a, const double b, double& x, double& y)
+	{
+		x = a - b;
+		const double bVirtual = a - x;
+		const double aVirtual = x + bVirtual;
+		y = (a - aVirtual) + (bVirtual - b);
+	}
+
+	void Split (const double a, double& high, double& low)
+	{
+		const double c = kSplitter * a;
+		high = c - (c - a);
+		low = a - high;
+	}
+
+	void TwoProduct (const double a, const double b, double& x, double& y)
+	{
+		x = a * b;
+		double aHigh, aLow, bHigh, bLow;
+		Split(a, aHigh, aLow);
+		Split(b, bHigh, bLow);
+		const double error = x - aHigh * bHigh - aLow * bHigh - aHigh * bLow;
+		y = aLow * bLow - error;
+	}
+
+	/*
+	 * Expansions are sums of non-overlapping doubles sorted by increasing magnitude, without zeros.
+	 */
+	Expansion Difference (const double a, const double b)
+	{
+		double x, y;
+		TwoDiff(a, b, x, y);
+		Expansion h;
+		if (y != 0)
+		{
+			h.push_back(y);
+		}
+		if (x != 0)
+		{
+			h.push_back(x);
+		}
+		return h;
+	}
+
+	/**
+	 * fast_expansion_sum_zeroelim
+	 */
+	Expansion Sum (const Expansion& e, const Expansion& f)
+	{
+		if (e.empty())
+		{
+			return f;
+		}
+		if (f.empty())
+		{
+			return e;
+		}
+
+		Expansion h;
+		h.reserve(e.size() + f.size());
+		size_t i = 0, j = 0;
+		double q, x, y;
+
+		// Merge by increasing magnitude
+		const auto next = [&]() {
+			return (j >= f.size() || (i < e.size() && std::abs(e[i]) < std::abs(f[j]))) ? e[i++] : f[j++];
+		};
+
+		q = next();
+		if (i + j < e.size() + f.size())
+		{
+			FastTwoSum(next(), q, x, y);
+			q = x;
+			if (y != 0)
+			{
+				h.push_back(y);
+			}
+			while (i + j < e.size() + f.size())
+			{
+				TwoSum(q, next(), x, y);
+				q = x;
+				if (y != 0)
+				{
+					h.push_back(y);
+				}
+			}
+		}
+		if (q != 0 || h.empty())
+		{
+			h.push_back(q);
+		}
+		if (h.size() == 1 && h[0] == 0)
+		{
+			h.clear();
+		}
+		return h;
+	}
+
+	Expansion Negate (Expansion e)
+	{
+		for (auto& component : e)
+		{
+			component = -component;
+		}
+		return e;
+	}
+
+	Expansion Subtract (const Expansion& e, const Expansion& f)
+	{
+		return Sum(e, Negate(f));
+	}
+
+	/**
+	 * scale_expansion_zeroelim
+	 */
+	Expansion Scale (const Expansion& e, const double b)
+	{
+		Expansion h;
+		if (e.empty() || b == 0)
+		{
+			return h;
+		}
+
+		h.reserve(2 * e.size());
+		double q, x, y, product, productError;
+		TwoProduct(e[0], b, q, y);
+		if (y != 0)
+		{
+			h.push_back(y);
+		}
+		for (size_t i = 1; i < e.size(); ++i)
+		{
+			TwoProduct(e[i], b, product, productError);
+			TwoSum(q, productError, x, y);
+			if (y != 0)
+			{
+				h.push_back(y);
+			}
+			FastTwoSum(product, x, q, y);
+			if (y != 0)
+			{
+				h.push_back(y);
+			}
+		}
+		if (q != 0)
+		{
+			h.push_back(q);
+		}
+		return h;
+	}
+
+	Expansion Product (const Expansion& e, const Expansion& f)
+	{
+		Expansion h;
+		for (const auto component : f)
+		{
+			h = Sum(h, Scale(e, component));
+		}
+		return h;
+	}
+
+	double Estimate (const Expansion& e)
+	{
+		double sum = 0;
+		for (const auto component : e)
+		{
+			sum += component;
+		}
+		return sum;
+	}
+
+	double Orient2DExact (const Math::Vec2d& a, const Math::Vec2d& b, const Math::Vec2d& c)
+	{
+		const auto acx = Difference(a.x, c.x);
+		const auto acy = Difference(a.y, c.y);
+		const auto bcx = Difference(b.x, c.x);
+		const auto bcy = Difference(b.y, c.y);
+		return Estimate(Subtract(Product(acx, bcy), Product(acy, bcx)));
+	}
+
+	double Orient3DExact (const Math::Vec3d& a, const Math::Vec3d& b, const Math::Vec3d& c, const Math::Vec3d& d)
+	{
+		const auto adx = Difference(a.x, d.x), ady = Difference(a.y, d.y), adz = Difference(a.z, d.z);
+		const auto bdx = Difference(b.x, d.x), bdy = Difference(b.y, d.y), bdz = Difference(b.z, d.z);
+		const auto cdx = Difference(c.x, d.x), cdy = Difference(c.y, d.y), cdz = Difference(c.z, d.z);
+
+		const auto bc = Subtract(Product(bdx, cdy), Product(cdx, bdy));
+		const auto ca = Subtract(Product(cdx, ady), Product(adx, cdy));
+		const auto ab = Subtract(Product(adx, bdy), Product(bdx, ady));
+		return Estimate(Sum(Sum(Product(adz, bc), Product(bdz, ca)), Product(cdz, ab)));
+	}
+
+	double InCircleExact (const Math::Vec2d& a, const Math::Vec2d& b, const Math::Vec2d& c, const Math::Vec2d& d)
+	{
+		const auto adx = Difference(a.x, d.x), ady = Difference(a.y, d.y);
+		const auto bdx = Difference(b.x, d.x), bdy = Difference(b.y, d.y);
+		const auto cdx = Difference(c.x, d.x), cdy = Difference(c.y, d.y);
+
+		const auto alift = Sum(Product(adx, adx), Product(ady, ady));
+		const auto blift = Sum(Product(bdx, bdx), Product(bdy, bdy));
+		const auto clift = Sum(Product(cdx, cdx), Product(cdy, cdy));
+
+		const auto bc = Subtract(Product(bdx, cdy), Product(cdx, bdy));
+		const auto ca = Subtract(Product(cdx, ady), Product(adx, cdy));
+		const auto ab = Subtract(Product(adx, bdy), Product(bdx, ady));
+		return Estimate(Sum(Sum(Product(alift, bc), Product(blift, ca)), Product(clift, ab)));
+	}
+
+	double InSphereExact (const Math::Vec3d& a, const Math::Vec3d& b, const Math::Vec3d& c, const Math::Vec3d& d, const Math::Vec3d& e)
+	{
+		const auto aex = Difference(a.x, e.x), aey = Difference(a.y, e.y), aez = Difference(a.z, e.z);
+		const auto bex = Difference(b.x, e.x), bey = Difference(b.y, e.y), bez = Difference(b.z, e.z);
+		const auto cex = Difference(c.x, e.x), cey = Difference(c.y, e.y), cez = Difference(c.z, e.z);
+		const auto dex = Difference(d.x, e.x), dey = Difference(d.y, e.y), dez = Difference(d.z, e.z);
+
+		const auto ab = Subtract(Product(aex, bey), Product(bex, aey));
+		const auto bc = Subtract(Product(bex, cey), Product(cex, bey));
+		const auto cd = Subtract(Product(cex, dey), Product(dex, cey));
+		const auto da = Subtract(Product(dex, aey), Product(aex, dey));
+		const auto ac = Subtract(Product(aex, cey), Product(cex, aey));
+		const auto bd = Subtract(Product(bex, dey), Product(dex, bey));
+
+		const auto abc = Sum(Subtract(Product(aez, bc), Product(bez, ac)), Product(cez, ab));
+		const auto bcd = Sum(Subtract(Product(bez, cd), Product(cez, bd)), Product(dez, bc));
+		const auto cda = Sum(Sum(Product(cez, da), Product(dez, ac)), Product(aez, cd));
+		const auto dab = Sum(Sum(Product(dez, ab), Product(aez, bd)), Product(bez, da));
+
+		const auto alift = Sum(Sum(Product(aex, aex), Product(aey, aey)), Product(aez, aez));
+		const auto blift = Sum(Sum(Product(bex, bex), Product(bey, bey)), Product(bez, bez));
+		const auto clift = Sum(Sum(Product(cex, cex), Product(cey, cey)), Product(cez, cez));
+		const auto dlift = Sum(Sum(Product(dex, dex), Product(dey, dey)), Product(dez, dez));
+
+		return Estimate(Sum(Subtract(Product(dlift, abc), Product(clift, dab)), Subtract(Product(blift, cda), Product(alift, bcd))));
+	}
+}
+
+double Math::Orient2D (const Vec2d& a, const Vec2d& b, const Vec2d& c)
+{
+	const double left = (a.x - c.x) * (b.y - c.y);
+	const double right = (a.y - c.y) * (b.x - c.x);
+	const double det = left - right;
+
+	// Terms of opposite signs cannot cancel, the naive result is exact in sign
+	double sum;
+	if (left > 0)
+	{
+		if (right <= 0)
+		{
+			return det;
+		}
+		sum = left + right;
+	}
+	else if (left < 0)
+	{
+		if (right >= 0)
+		{
+			return det;
+		}
+		sum = -left - right;
+	}
+	else
+	{
+		return det;
+	}
+
+	const double bound = kOrient2DBound * sum;
+	if (det >= bound || -det >= bound)
+	{
+		return det;
+	}
+	return Orient2DExact(a, b, c);
+}
+
+double Math::Orient3D (const Vec3d& a, const Vec3d& b, const Vec3d& c, const Vec3d& d)
+{
+	const double adx = a.x - d.x, ady = a.y - d.y, adz = a.z - d.z;
+	const double bdx = b.x - d.x, bdy = b.y - d.y, bdz = b.z - d.z;
+	const double cdx = c.x - d.x, cdy = c.y - d.y, cdz = c.z - d.z;
+
+	const double bdxcdy = bdx * cdy, cdxbdy = cdx * bdy;
+	const double cdxady = cdx * ady, adxcdy = adx * cdy;
+	const double adxbdy = adx * bdy, bdxady = bdx * ady;
+
+	const double det = adz * (bdxcdy - cdxbdy) + bdz * (cdxady - adxcdy) + cdz * (adxbdy - bdxady);
+	const double permanent = (std::abs(bdxcdy) + std::abs(cdxbdy)) * std::abs(adz)
+		+ (std::abs(cdxady) + std::abs(adxcdy)) * std::abs(bdz)
+		+ (std::abs(adxbdy) + std::abs(bdxady)) * std::abs(cdz);
+
+	const double bound = kOrient3DBound * permanent;
+	if (det > bound || -det > bound)
+	{
+		return det;
+	}
+	return Orient3DExact(a, b, c, d);
+}
+
+double Math::InCircle (const Vec2d& a, const Vec2d& b, const Vec2d& c, const Vec2d& d)
+{
+	const double adx = a.x - d.x, ady = a.y - d.y;
+	const double bdx = b.x - d.x, bdy = b.y - d.y;
+	const double cdx = c.x - d.x, cdy = c.y - d.y;
+
+	const double bdxcdy = bdx * cdy, cdxbdy = cdx * bdy;
+	const double cdxady = cdx * ady, adxcdy = adx * cdy;
+	const double adxbdy = adx * bdy, bdxady = bdx * ady;
+	const double alift = adx * adx + ady * ady;
+	const double blift = bdx * bdx + bdy * bdy;
+	const double clift = cdx * cdx + cdy * cdy;
+
+	const double det = alift * (bdxcdy - cdxbdy) + blift * (cdxady - adxcdy) + clift * (adxbdy - bdxady);
+	const double permanent = (std::abs(bdxcdy) + std::abs(cdxbdy)) * alift
+		+ (std::abs(cdxady) + std::abs(adxcdy)) * blift
+		+ (std::abs(adxbdy) + std::abs(bdxady)) * clift;
+
+	const double bound = kInCircleBound * permanent;
+	if (det > bound || -det > bound)
+	{
+		return det;
+	}
+	return InCircleExact(a, b, c, d);
+}
+
+double Math::InSphere (const Vec3d& a, const Vec3d& b, const Vec3d& c, const Vec3d& d, const Vec3d& e)
+{
+	const double aex = a.x - e.x, aey = a.y - e.y, aez = a.z - e.z;
+	const double bex = b.x - e.x, bey = b.y - e.y, bez = b.z - e.z;
+	const double cex = c.x - e.x, cey = c.y - e.y, cez = c.z - e.z;
+	const double dex = d.x - e.x, dey = d.y - e.y, dez = d.z - e.z;
+
+	const double aexbey = aex * bey, bexaey = bex * aey;
+	const double bexcey = bex * cey, cexbey = cex * bey;
+	const double cexdey = cex * dey, dexcey = dex * cey;
+	const double dexaey = dex * aey, aexdey = aex * dey;
+	const double aexcey = aex * cey, cexaey = cex * aey;
+	const double bexdey = bex * dey, dexbey = dex * bey;
+
+	const double ab = aexbey - bexaey;
+	const double bc = bexcey - cexbey;
+	const double cd = cexdey - dexcey;
+	const double da = dexaey - aexdey;
+	const double ac = aexcey - cexaey;
+	const double bd = bexdey - dexbey;
+
+	const double abc = aez * bc - bez * ac + cez * ab;
+	const double bcd = bez * cd - cez * bd + dez * bc;
+	const double cda = cez * da + dez * ac + aez * cd;
+	const double dab = dez * ab + aez * bd + bez * da;
+
+	const double alift = aex * aex + aey * aey + aez * aez;
+	const double blift = bex * bex + bey * bey + bez * bez;
+	const double clift = cex * cex + cey * cey + cez * cez;
+	const double dlift = dex * dex + dey * dey + dez * dez;
+
+	const double det = (dlift * abc - clift * dab) + (blift * cda - alift * bcd);
+
+	const double aez2 = std::abs(aez), bez2 = std::abs(bez), cez2 = std::abs(cez), dez2 = std::abs(dez);
+	const double ab2 = std::abs(aexbey) + std::abs(bexaey);
+	const double bc2 = std::abs(bexcey) + std::abs(cexbey);
+	const double cd2 = std::abs(cexdey) + std::abs(dexcey);
+	const double da2 = std::abs(dexaey) + std::abs(aexdey);
+	const double ac2 = std::abs(aexcey) + std::abs(cexaey);
+	const double bd2 = std::abs(bexdey) + std::abs(dexbey);
+	const double permanent = (cd2 * bez2 + bd2 * cez2 + bc2 * dez2) * alift
+		+ (da2 * cez2 + ac2 * dez2 + cd2 * aez2) * blift
+		+ (ab2 * dez2 + bd2 * aez2 + da2 * bez2) * clift
+		+ (bc2 * aez2 + ac2 * bez2 + ab2 * cez2) * dlift;
+
+	const double bound = kInSphereBound * permanent;
+	if (det > bound || -det > bound)
+	{
+		return det;
+	}
+	return InSphereExact(a, b, c, d, e);
+}
@@ -0,0 +1,206 @@
+﻿#include "SpatialSort.hpp"
+#if defined(__BMI2__)
+#include <immintrin.h>
+#endif
+
+namespace
+{
+	const unsigned kRadixBits = 11;
+	const size_t kGrainSize = 1 << 14;
+
+#if !defined(__BMI2__)
+	/**
+	 * Bits of value 1 apart
+	 */
+	std::uint64_t Spread2 (std::uint64_t value)
+	{
+		value &= 0xFFFFFFFF;
+		value = (value | value << 16) & 0x0000FFFF0000FFFF;
+		value = (value | value << 8) & 0x00FF00FF00FF00FF;
+		value = (value | value << 4) & 0x0F0F0F0F0F0F0F0F;
+		value = (value | value << 2) & 0x3333333333333333;
+		value = (value | value << 1) & 0x5555555555555555;
+		return value;
+	}
+
+	/**
+	 * Lowest 21 bits of value 2 apart
+	 */
+	std::uint64_t Spread3 (std::uint64_t value)
+	{
+		value &= 0x1FFFFF;
+		value = (value | value << 32) & 0x1F00000000FFFF;
+		value = (value | value << 16) & 0x1F0000FF0000FF;
+		value = (value | value << 8) & 0x100F00F00F00F00F;
+		value = (value | value << 4) & 0x10C30C30C30C30C3;
+		value = (value | value << 2) & 0x1249249249249249;
+		return value;
+	}
+#endif
+}
+
+std::uint64_t Math::Morton2D (const std::uint32_t x, const std::uint32_t y)
+{
+#if defined(__BMI2__)
+	return _pdep_u64(x, 0xAAAAAAAAAAAAAAAA) | _pdep_u64(y, 0x5555555555555555);
+#else
+	return Spread2(x) << 1 | Spread2(y);
+#endif
+}
+
+std::uint64_t Math::Morton3D (const std::uint32_t x, const std::uint32_t y, const std::uint32_t z)
+{
+#if defined(__BMI2__)
+	return _pdep_u64(x, 0x4924924924924924) | _pdep_u64(y, 0x2492492492492492) | _pdep_u64(z, 0x1249249249249249);
+#else
+	return Spread3(x) << 2 | Spread3(y) << 1 | Spread3(z);
+#endif
+}
+
+std::uint64_t Math::Hilbert2D (std::uint32_t x, std::uint32_t y, const unsigned order)
+{
+	if (order == 0 || order > 32)
+	{
+		throw std::invalid_argument("Hilbert order must be between 1 and 32");
+	}
+
+	// Quadrant by quadrant from the top, rotating the lower bits into the frame of the quadrant
+	std::uint64_t d = 0;
+	for (std::uint32_t s = std::uint32_t(1) << (order - 1); s > 0; s >>= 1)
+	{
+		const std::uint32_t rx = (x & s) ? 1 : 0;
+		const std::uint32_t ry = (y & s) ? 1 : 0;
+		d += std::uint64_t(s) * s * ((3 * rx) ^ ry);
+		if (ry == 0)
+		{
+			if (rx == 1)
+			{
+				x = s - 1 - (x & (s - 1));
+				y = s - 1 - (y & (s - 1));
+			}
+			std::swap(x, y);
+		}
+	}
+	return d;
+}
+
+std::uint64_t Math::Hilbert3D (const std::uint32_t x, const std::uint32_t y, const std::uint32_t z, const unsigned order)
+{
+	if (order == 0 || order > 21)
+	{
+		throw std::invalid_argument("Hilbert order must be between 1 and 21");
+	}
+
+	// Skilling's transform: the interleaved bits of the transposed coordinates are the curve index
+	std::uint32_t axes[3] = { x, y, z };
+	const std::uint32_t top = std::uint32_t(1) << (order - 1);
+	for (std::uint32_t q = top; q > 1; q >>= 1)
+	{
+		const std::uint32_t p = q - 1;
+		for (unsigned i = 0; i < 3; ++i)
+		{
+			if (axes[i] & q)
+			{
+				axes[0] ^= p;
+			}
+			else
+			{
+				const std::uint32_t t = (axes[0] ^ axes[i]) & p;
+				axes[0] ^= t;
+				axes[i] ^= t;
+			}
+		}
+	}
+
+	// Gray encode
+	axes[1] ^= axes[0];
+	axes[2] ^= axes[1];
+	std::uint32_t t = 0;
+	for (std::uint32_t q = top; q > 1; q >>= 1)
+	{
+		if (axes[2] & q)
+		{
+			t ^= q - 1;
+		}
+	}
+	return Morton3D(axes[0] ^ t, axes[1] ^ t, axes[2] ^ t);
+}
+
+void Math::RadixSort (std::uint64_t* keys, std::uint32_t* values, const size_t count, const unsigned bits)
+{
+	if (bits > 64)
+	{
+		throw std::invalid_argument("Keys have 64 bits");
+	}
+	if (count < 2 || bits == 0)
+	{
+		return;
+	}
+
+	// Least significant digit first: a stable counting sort per digit, each chunk counting then
+	//	scattering its own part of the keys
+	const size_t chunks = ParallelChunks(count, kGrainSize);
+	const size_t radix = size_t(1) << kRadixBits;
+	ScratchVector<std::uint64_t> keyBuffer(count);
+	ScratchVector<std::uint32_t> valueBuffer(values ? count : 0);
+	ScratchVector<size_t> offsets(chunks * radix);
+	std::uint64_t* from = keys;
+	std::uint64_t* to = keyBuffer.data();
+	std::uint32_t* valuesFrom = values;
+	std::uint32_t* valuesTo = valueBuffer.data();
+	for (unsigned shift = 0; shift < bits; shift += kRadixBits)
+	{
+		// The last digit only holds the bits left to sort
+		const std::uint64_t mask = (radix - 1) >> (kRadixBits - std::min(kRadixBits, bits - shift));
+		std::fill(offsets.begin(), offsets.end(), size_t(0));
+		ParallelForChunks(count, kGrainSize, [&](const size_t chunk, const size_t first, const size_t last) {
+			size_t* counts = offsets.data() + chunk * radix;
+			for (size_t i = first; i < last; ++i)
+			{
+				++counts[from[i] >> shift & mask];
+			}
+		});
+
+		// A digit shared by all keys leaves them in place
+		size_t offset = 0;
+		bool sorted = false;
+		for (size_t digit = 0; digit < radix; ++digit)
+		{
+			for (size_t chunk = 0; chunk < chunks; ++chunk)
+			{
+				const size_t digitCount = offsets[chunk * radix + digit];
+				offsets[chunk * radix + digit] = offset;
+				offset += digitCount;
+				sorted = sorted || digitCount == count;
+			}
+		}
+		if (sorted)
+		{
+			continue;
+		}
+
+		ParallelForChunks(count, kGrainSize, [&](const size_t chunk, const size_t first, const size_t last) {
+			size_t* next = offsets.data() + chunk * radix;
+			for (size_t i = first; i < last; ++i)
+			{
+				const size_t position = next[from[i] >> shift & mask]++;
+				to[position] = from[i];
+				if (valuesFrom)
+				{
+					valuesTo[position] = valuesFrom[i];
+				}
+			}
+		});
+		std::swap(from, to);
+		std::swap(valuesFrom, valuesTo);
+	}
+
+	if (from != keys)
+	{
+		std::copy(from, from + count, keys);
+		if (values)
+		{
+			std::copy(valuesFrom, valuesFrom + count, values);
+		}
+	}
+}